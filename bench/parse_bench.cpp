@@ -0,0 +1,85 @@
+// Parsing time of a large source into the different trees. Built with cmake
+// -DSDATA_BUILD_BENCHMARKS=ON
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "sdata.hpp"
+
+namespace {
+
+constexpr size_t ROUNDS = 3;
+constexpr size_t GROUPS = 50000;
+
+// 500k nodes, groups of nine values of every type
+std::string groups(size_t count) {
+  std::string source = "groups {\n";
+
+  for (size_t i = 0; i < count; i++) {
+    std::string index = std::to_string(i);
+    source += "  group_" + index + " { id: " + index + ", ratio: " + index +
+              ".5, name: \"group number " + index +
+              "\", enabled: true, tag: 'g', x: -1, y: 2, z: 3, label: \"label\" },\n";
+  }
+
+  return source + "  last: 0\n}\n";
+}
+
+// Counts the values, as consumers filling their own structures would visit them
+struct Counter {
+  void key(std::string_view) {}
+  void begin_sequence() {}
+  void end_sequence() {}
+
+  template <typename T>
+  void value(T) {
+    values++;
+  }
+
+  size_t values = 0;
+};
+
+template <typename Function>
+double best_milliseconds(Function function) {
+  double best = 1e300;
+
+  for (size_t round = 0; round < ROUNDS; round++) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count());
+  }
+
+  return best;
+}
+
+void report(std::string_view name, double milliseconds) {
+  std::cout << "  " << std::left << std::setw(10) << name << std::right << std::fixed
+            << std::setprecision(1) << std::setw(8) << milliseconds << " ms" << std::endl;
+}
+
+}  // namespace
+
+int main() {
+  std::string source = groups(GROUPS);
+  std::cout << source.size() / (1 << 20) << " MiB, " << GROUPS * 10 << " nodes" << std::endl;
+
+  report("node", best_milliseconds([&] { sdata::from_source<char>(source); }));
+  report("document", best_milliseconds([&] { sdata::document_from_source<char>(source); }));
+  report("view", best_milliseconds([&] {
+    sdata::document_from_source<char>(source, sdata::DOCUMENT_VIEW);
+  }));
+  report("events", best_milliseconds([&] { sdata::parse_events<char>(source, Counter{}); }));
+
+  // The last node, every group being skipped
+  report("reader", best_milliseconds([&] {
+    sdata::Reader<char> reader{source};
+    reader.next();
+    reader.enter();
+    while (reader.next() && reader.key() != "last") {}
+    return reader.value<int>();
+  }));
+
+  return 0;
+}
@@ -0,0 +1,73 @@
+// Token lexer throughput of the dfa tables against the jit and the generated scanner,
+// built with cmake -DSDATA_BUILD_BENCHMARKS=ON
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "scanner.hpp"
+#include "token.hpp"
+
+namespace {
+
+constexpr std::string_view RECORD =
+    "player: {\n"
+    "  name: \"Sdata the brave\", level: 42, ratio: -0.875f,\n"
+    "  alive: true, initial: 's', inventory: { sword: 1, potion: 12 }\n"
+    "}\n";
+
+constexpr size_t REPEAT = 1 << 16;
+constexpr size_t ROUNDS = 5;
+
+// Scans every token of the source, returns the token count
+template <typename Lexer>
+size_t tokenize(std::string_view source, Lexer lexer) {
+  size_t count = 0;
+
+  for (auto input = source.begin(); input != source.end(); count++) {
+    sdata::RegexMatch match = lexer(input, source.end());
+    input += match.length != 0 ? match.length : 1;
+  }
+
+  return count;
+}
+
+template <typename Lexer>
+void benchmark(std::string_view name, std::string_view source, Lexer lexer) {
+  double best = 0.0;
+  size_t count = 0;
+
+  for (size_t round = 0; round < ROUNDS; round++) {
+    auto start = std::chrono::steady_clock::now();
+    count = tokenize(source, lexer);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    best = std::max(best, source.size() / elapsed.count() / (1 << 20));
+  }
+
+  std::cout << std::setw(12) << name << ": " << std::fixed << std::setprecision(1) << best
+            << " MiB/s (" << count << " tokens)" << std::endl;
+}
+
+}  // namespace
+
+int main() {
+  std::string source{};
+  for (size_t i = 0; i < REPEAT; i++) source += RECORD;
+
+  const sdata::RegexJit &jit = sdata::token_lexer_jit();
+  std::cout << "jit: " << (jit.native() ? "native" : "fallback") << ", " << jit.size()
+            << " bytes of code" << std::endl;
+
+  benchmark("dfa", source, [](auto begin, auto end) {
+    return sdata::s_token_lexer.run(begin, end);
+  });
+  benchmark("jit", source, [&jit](auto begin, auto end) { return jit.run(begin, end); });
+
+#ifdef SDATA_TOKEN_LEXER_GENERATED
+  benchmark("generated", source, [](auto begin, auto end) {
+    return sdata::token_lexer_generated(begin, end);
+  });
+#endif
+
+  return 0;
+}
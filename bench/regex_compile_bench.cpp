@@ -0,0 +1,75 @@
+// Regex compile time against pattern size, for patterns built at runtime such as alternatives of
+// schema field names. Built with cmake -DSDATA_BUILD_BENCHMARKS=ON
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "regex/regex.hpp"
+
+namespace {
+
+constexpr size_t ROUNDS = 5;
+
+// 'field_0:'|'field_1:'|...
+std::string field_names(size_t count) {
+  std::string pattern{};
+
+  for (size_t i = 0; i < count; i++) {
+    pattern += (i > 0 ? "|'field_" : "'field_") + std::to_string(i) + ":'";
+  }
+
+  return pattern;
+}
+
+// 'key_0=' {n+|Q a* Q} ';' 'key_1=' ...
+std::string records(size_t count) {
+  std::string pattern{};
+
+  for (size_t i = 0; i < count; i++) {
+    pattern += "'key_" + std::to_string(i) + "=' {n+|Q a* Q} ';' ";
+  }
+
+  return pattern;
+}
+
+template <typename Function>
+double best_microseconds(Function function) {
+  double best = 1e300;
+
+  for (size_t round = 0; round < ROUNDS; round++) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count());
+  }
+
+  return best;
+}
+
+void benchmark(std::string_view name, std::string (*generate)(size_t)) {
+  std::cout << name << std::endl;
+
+  for (size_t count : {16, 64, 256, 1024}) {
+    std::string pattern = generate(count);
+    size_t nodes = 0, states = 0;
+
+    double parse = best_microseconds([&] { nodes = sdata::RegexParser{pattern}.parse().size(); });
+    double dfa = best_microseconds([&] {
+      states = sdata::RegexDfa{sdata::RegexParser{pattern}.parse()}.size();
+    });
+
+    std::cout << "  " << std::setw(5) << count << " x " << std::setw(7) << pattern.size()
+              << " bytes: parse " << std::fixed << std::setprecision(1) << std::setw(10) << parse
+              << " us (" << nodes << " nodes), parse + dfa " << std::setw(11) << dfa << " us ("
+              << states << " states)" << std::endl;
+  }
+}
+
+}  // namespace
+
+int main() {
+  benchmark("field names", field_names);
+  benchmark("records", records);
+  return 0;
+}
@@ -0,0 +1,69 @@
+// Tokenizing time of a large source against the thread count. Built with cmake
+// -DSDATA_BUILD_BENCHMARKS=ON
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "scanner.hpp"
+
+namespace {
+
+constexpr size_t ROUNDS = 3;
+constexpr size_t RECORDS = 1 << 20;
+
+// Records of every token category, about 100 bytes each
+std::string records(size_t count) {
+  std::string source = "records: {\n";
+
+  for (size_t i = 0; i < count; i++) {
+    std::string index = std::to_string(i);
+    source += "  record_" + index + ": { id: " + index + ", ratio: -" + index +
+              ".25f, name: \"record, number " + index + "\", flag: true, tag: 'r' },\n";
+  }
+
+  return source + "}\n";
+}
+
+template <typename Function>
+double best_milliseconds(Function function) {
+  double best = 1e300;
+
+  for (size_t round = 0; round < ROUNDS; round++) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count());
+  }
+
+  return best;
+}
+
+}  // namespace
+
+int main() {
+  std::string source = records(RECORDS);
+  size_t tokens = 0;
+
+  double sequential = best_milliseconds([&] {
+    tokens = sdata::Scanner<char>{source}.tokenize_all().size();
+  });
+
+  std::cout << source.size() / (1 << 20) << " MiB, " << tokens << " tokens" << std::endl;
+  std::cout << "  sequential: " << std::fixed << std::setprecision(1) << std::setw(8) << sequential
+            << " ms" << std::endl;
+
+  for (size_t threads = 2; threads <= std::max(2u, std::thread::hardware_concurrency());
+       threads *= 2) {
+    double parallel = best_milliseconds([&] {
+      tokens = sdata::Scanner<char>{source}.tokenize_parallel(threads).size();
+    });
+
+    std::cout << "  " << std::setw(2) << threads << " threads: " << std::setw(8) << parallel
+              << " ms (x" << std::setprecision(2) << sequential / parallel << ")"
+              << std::setprecision(1) << std::endl;
+  }
+
+  return 0;
+}
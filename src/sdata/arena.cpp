@@ -0,0 +1,15 @@
+#include "arena.hpp"
+
+namespace sdata {
+
+void Arena::grow(size_t size) {
+  size_t capacity = std::max(m_next_block, size);
+
+  // The storage is left uninitialized, objects are constructed in place
+  m_blocks.emplace_back(new std::byte[capacity]);
+  m_cursor = m_blocks.back().get();
+  m_end = m_cursor + capacity;
+  m_next_block = capacity * 2;
+}
+
+}  // namespace sdata
@@ -0,0 +1,115 @@
+#ifndef SDATA_ARENA_HPP
+#define SDATA_ARENA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sdata {
+
+// Monotonic allocator handing out memory from blocks of doubling size. Nothing is freed before the
+// arena is, and objects are never destroyed: only trivially destructible types are stored. Moving
+// the arena keeps the addresses of its objects.
+class Arena {
+ public:
+  constexpr static size_t BLOCK = 64 * 1024;  // Size of the first block
+
+  explicit Arena(size_t block = BLOCK) : m_next_block(std::max<size_t>(block, 1)) {}
+
+  // The moved from arena is left empty rather than allocating in the moved blocks
+  Arena(Arena &&other) noexcept
+      : m_blocks(std::move(other.m_blocks)),
+        m_cursor(std::exchange(other.m_cursor, nullptr)),
+        m_end(std::exchange(other.m_end, nullptr)),
+        m_next_block(other.m_next_block),
+        m_used(std::exchange(other.m_used, 0)) {
+    other.m_blocks.clear();
+  }
+
+  Arena &operator=(Arena &&other) noexcept {
+    std::swap(m_blocks, other.m_blocks);
+    std::swap(m_cursor, other.m_cursor);
+    std::swap(m_end, other.m_end);
+    std::swap(m_next_block, other.m_next_block);
+    std::swap(m_used, other.m_used);
+    return *this;
+  }
+
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  inline void *allocate(size_t size, size_t alignment) {
+    size_t padding = -reinterpret_cast<uintptr_t>(m_cursor) & (alignment - 1);
+
+    if (m_cursor == nullptr || padding + size > static_cast<size_t>(m_end - m_cursor)) {
+      grow(size + alignment);
+      padding = -reinterpret_cast<uintptr_t>(m_cursor) & (alignment - 1);
+    }
+
+    std::byte *data = m_cursor + padding;
+    m_cursor = data + size;
+    m_used += size;
+
+    return data;
+  }
+
+  // Uninitialized storage for count objects
+  template <typename T>
+  T *allocate(size_t count) {
+    static_assert(std::is_trivially_destructible_v<T>, "Arena objects are never destroyed");
+    return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+  }
+
+  template <typename T, typename... Args>
+  T *create(Args &&...args) {
+    return new (allocate<T>(1)) T(std::forward<Args>(args)...);
+  }
+
+  template <typename T>
+  std::span<T> copy(std::span<const T> values) {
+    static_assert(std::is_trivially_copyable_v<T>, "Arena copies are raw copies");
+    if (values.empty()) return {};
+
+    T *data = allocate<T>(values.size());
+    std::memcpy(data, values.data(), values.size_bytes());
+    return {data, values.size()};
+  }
+
+  template <typename CharT>
+  std::basic_string_view<CharT> copy(std::basic_string_view<CharT> string) {
+    std::span<CharT> copied = copy(std::span<const CharT>{string.data(), string.size()});
+    return {copied.data(), copied.size()};
+  }
+
+  // Blocks allocated so far, each one being a single allocation
+  inline size_t blocks() const {
+    return m_blocks.size();
+  }
+
+  // Bytes handed out, alignment padding excluded
+  inline size_t used() const {
+    return m_used;
+  }
+
+ private:
+  // Starts a new block large enough for size bytes
+  void grow(size_t size);
+
+  std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+  std::byte *m_cursor = nullptr;
+  std::byte *m_end = nullptr;
+  size_t m_next_block;
+  size_t m_used = 0;
+};
+
+}  // namespace sdata
+
+#endif
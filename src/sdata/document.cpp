@@ -0,0 +1,11 @@
+#include "document.hpp"
+#include "misc/fmt.hpp"
+
+namespace sdata {
+
+DocumentException::DocumentException(std::string_view description,
+                                     std::string_view id,
+                                     Node::Type type)
+    : m_buffer(fmt<char>(PATTERN, description, id, Node::type_name(type))) {}
+
+}  // namespace sdata
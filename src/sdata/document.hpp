@@ -0,0 +1,193 @@
+#ifndef SDATA_DOCUMENT_HPP
+#define SDATA_DOCUMENT_HPP
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include "arena.hpp"
+#include "misc/any_of.hpp"
+#include "node.hpp"
+
+namespace sdata {
+
+template <typename CharT>
+class Parser;
+
+class DocumentException : public std::exception {
+  constexpr static std::string_view PATTERN =
+      "[sdata::DocumentException raised]: %\n"
+      "with {id: \"%\", type: %}";
+
+ public:
+  DocumentException(std::string_view description, std::string_view id, Node::Type type);
+
+  inline const char *what() const noexcept override {
+    return m_buffer.data();
+  }
+
+ private:
+  const std::string m_buffer;
+};
+
+// Where the identifiers and strings of a document are stored
+enum DocumentStorage {
+  DOCUMENT_COPY,  // In the arena of the document
+  DOCUMENT_VIEW,  // Nowhere, they are views into the source
+};
+
+// Node of a document, stored in its arena along with its identifier, strings and members. Members
+// of a sequence are stored contiguously. Alternatives follow the order of the Node variant, so
+// types are shared with Node.
+template <typename CharT>
+class DocumentNode {
+  using StringViewT = std::basic_string_view<CharT>;
+
+ public:
+  using Sequence = std::span<const DocumentNode>;
+  using Variant = std::variant<std::nullptr_t,
+                               Sequence,
+                               float,
+                               int,
+                               bool,
+                               char,
+                               char16_t,
+                               char32_t,
+                               std::string_view,
+                               std::u16string_view,
+                               std::u32string_view,
+                               double,
+                               int64_t,
+                               uint64_t>;
+
+  DocumentNode(StringViewT id, Variant data) : m_identifier(id), m_variant(data) {}
+
+  inline Node::Type type() const {
+    return static_cast<Node::Type>(m_variant.index());
+  }
+
+  inline StringViewT id() const {
+    return m_identifier;
+  }
+
+  inline const Variant &variant() const {
+    return m_variant;
+  }
+
+  inline bool is_anonymous() const {
+    return m_identifier.empty();
+  }
+
+  template <typename T>
+  inline bool is() const {
+    return std::holds_alternative<T>(m_variant);
+  }
+
+  template <typename T>
+  const T &as() const {
+    if (!is<T>()) {
+      throw DocumentException{"Node does not contain data of the requested type",
+                              std::string(m_identifier.begin(), m_identifier.end()), type()};
+    }
+
+    return std::get<T>(m_variant);
+  }
+
+  inline Sequence members() const {
+    return as<Sequence>();
+  }
+
+  // Member at the slash separated path of identifiers, nullptr when there is none
+  const DocumentNode *at(StringViewT path) const {
+    const DocumentNode *node = this;
+
+    while (node != nullptr && !path.empty()) {
+      size_t length = std::min(path.find(CharT{'/'}), path.size());
+      StringViewT id = path.substr(0, length);
+      path.remove_prefix(std::min(length + 1, path.size()));
+
+      const DocumentNode *parent = node->is<Sequence>() ? node : nullptr;
+      node = nullptr;
+
+      for (const DocumentNode &member : parent ? parent->members() : Sequence{}) {
+        if (member.id() == id) {
+          node = &member;
+          break;
+        }
+      }
+    }
+
+    return node;
+  }
+
+  // Owning copy of the subtree
+  std::shared_ptr<Node> to_node() const {
+    auto node = std::make_shared<Node>(m_identifier, nullptr);
+
+    std::visit(
+        [&node](const auto &data) {
+          using T = std::decay_t<decltype(data)>;
+
+          if constexpr (std::is_same_v<T, Sequence>) {
+            node->assign(sdata::Sequence{});
+            for (const DocumentNode &member : data) node->emplace(member.to_node());
+          } else if constexpr (any_of<T, std::string_view, std::u16string_view,
+                                      std::u32string_view>) {
+            node->assign(std::basic_string<typename T::value_type>{data});
+          } else {
+            node->assign(data);
+          }
+        },
+        m_variant);
+
+    return node;
+  }
+
+ private:
+  StringViewT m_identifier;
+  Variant m_variant;
+};
+
+// Tree parsed in an arena: nodes, member arrays, identifiers and strings are all allocated from a
+// few large blocks, and released at once with the document. Nodes are referenced by plain
+// pointers, valid as long as the document is. Documents parsed with DOCUMENT_VIEW may pin their
+// source so that their strings stay valid, owning copies are made by DocumentNode::to_node.
+template <typename CharT>
+class Document {
+  using StringViewT = std::basic_string_view<CharT>;
+
+ public:
+  Document() = default;
+
+  // nullptr for empty sources
+  inline const DocumentNode<CharT> *root() const {
+    return m_root;
+  }
+
+  inline const DocumentNode<CharT> *at(StringViewT path) const {
+    return m_root ? m_root->at(path) : nullptr;
+  }
+
+  inline const Arena &arena() const {
+    return m_arena;
+  }
+
+  // Keeps the source viewed by the document alive as long as the document
+  inline void pin(std::shared_ptr<const void> source) {
+    m_pinned = std::move(source);
+  }
+
+ private:
+  friend class Parser<CharT>;
+
+  Arena m_arena;
+  std::shared_ptr<const void> m_pinned;
+  const DocumentNode<CharT> *m_root = nullptr;
+};
+
+}  // namespace sdata
+
+#endif
@@ -1,6 +1,9 @@
 #ifndef SDATA_EMITTER_HPP
 #define SDATA_EMITTER_HPP
 
+#include <array>
+#include <charconv>
+#include <cmath>
 #include <iomanip>
 #include <sstream>
 #include "emitter_config.hpp"
@@ -102,8 +105,14 @@ class Emitter {
         [&stream, &node](const auto &data) {
           using T = std::decay_t<decltype(data)>;
 
-          if constexpr (any_of<T, int, float>) {
-            stream << data;
+          if constexpr (any_of<T, int, int64_t, uint64_t, float, double>) {
+            if constexpr (std::is_floating_point_v<T>) {
+              if (!std::isfinite(data)) {
+                throw EmitterException{"Non finite numbers can't be emitted", node};
+              }
+            }
+
+            stream << string::convert<char, CharT>(number(data));
           }
           if constexpr (any_of<T, bool>) {
             stream << std::boolalpha << data;
@@ -124,6 +133,26 @@ class Emitter {
     return stream;
   }
 
+  // Shortest form reading back to the same value, in the fixed notation of the grammar
+  template <typename T>
+  static std::string number(T value) {
+    std::array<char, 512> buffer{};
+    char *end = nullptr;
+
+    if constexpr (std::is_floating_point_v<T>) {
+      end = std::to_chars(buffer.begin(), buffer.end(), value, std::chars_format::fixed).ptr;
+      if (std::find(buffer.begin(), end, '.') == end) end = std::copy_n(".0", 2, end);
+    } else {
+      end = std::to_chars(buffer.begin(), buffer.end(), value).ptr;
+    }
+
+    if constexpr (any_of<T, double>) *end++ = 'd';
+    if constexpr (any_of<T, int64_t>) *end++ = 'l';
+    if constexpr (any_of<T, uint64_t>) *end++ = 'u';
+
+    return {buffer.begin(), end};
+  }
+
   StreamT &stream_indent(StreamT &stream, std::size_t width) {
     for (std::size_t i = 0; i < width; i++) {
       stream << string::convert<char, CharT>(m_config.indent);
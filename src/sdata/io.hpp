@@ -26,9 +26,70 @@ std::shared_ptr<Node> from_source(std::basic_string_view<CharT> source) {
   return Parser<CharT>{source}.parse();
 }
 
+template <typename CharT>
+std::shared_ptr<Node> from_stream(std::basic_istream<CharT> &stream) {
+  return Parser<CharT>{stream}.parse();
+}
+
+// Files are streamed in chunks rather than read whole
 template <typename CharT>
 std::shared_ptr<Node> from_file(std::filesystem::path path) {
-  return from_source<CharT>(read_source_file<CharT>(path));
+  std::basic_ifstream<CharT> stream{path};
+
+  if (!stream.is_open()) {
+    throw std::runtime_error{
+        fmt<char>("Can't read source from: '%'", path.string()),
+    };
+  }
+
+  return from_stream<CharT>(stream);
+}
+
+// Calls the handler for each part of the source in order, no tree is built
+template <typename CharT, ParserHandler<CharT> Handler>
+void parse_events(std::basic_string_view<CharT> source, Handler &&handler) {
+  Parser<CharT>{source}.parse_events(handler);
+}
+
+template <typename CharT, ParserHandler<CharT> Handler>
+void parse_events(std::basic_istream<CharT> &stream, Handler &&handler) {
+  Parser<CharT>{stream}.parse_events(handler);
+}
+
+// Documents copy their identifiers and strings by default, the source can then be released once
+// parsed. With DOCUMENT_VIEW they point into the source, which must outlive the document.
+template <typename CharT>
+Document<CharT> document_from_source(std::basic_string_view<CharT> source,
+                                     DocumentStorage storage = DOCUMENT_COPY) {
+  return Parser<CharT>{source}.parse_document(storage);
+}
+
+// Identifiers and strings are views into the source, pinned by the document
+template <typename CharT>
+Document<CharT> document_from_source(std::shared_ptr<const std::basic_string<CharT>> source) {
+  Document<CharT> document = Parser<CharT>{*source}.parse_document(DOCUMENT_VIEW);
+  document.pin(std::move(source));
+  return document;
+}
+
+// Copying documents stream the file, viewing ones read it whole and pin it
+template <typename CharT>
+Document<CharT> document_from_file(std::filesystem::path path,
+                                   DocumentStorage storage = DOCUMENT_COPY) {
+  if (storage == DOCUMENT_VIEW) {
+    return document_from_source<CharT>(
+        std::make_shared<const std::basic_string<CharT>>(read_source_file<CharT>(path)));
+  }
+
+  std::basic_ifstream<CharT> stream{path};
+
+  if (!stream.is_open()) {
+    throw std::runtime_error{
+        fmt<char>("Can't read source from: '%'", path.string()),
+    };
+  }
+
+  return Parser<CharT>{stream}.parse_document();
 }
 
 namespace literals {
@@ -11,17 +11,23 @@ struct SourceLocation {
   using StringViewT = std::basic_string_view<CharT>;
 
  public:
+  // Counts the lines from the beginning of the source, in linear time
   constexpr SourceLocation(StringViewT source, typename StringViewT::const_iterator iterator)
-      : source(source),
-        index(std::distance(source.cbegin(), iterator)),
-        line(std::count(source.cbegin(), iterator, CharT{'\n'})) {}
+      : SourceLocation(source, iterator, std::count(source.cbegin(), iterator, CharT{'\n'})) {}
+
+  // Line known by the caller, such as the scanner which counts lines as it goes
+  constexpr SourceLocation(StringViewT source,
+                           typename StringViewT::const_iterator iterator,
+                           size_t line)
+      : source(source), index(std::distance(source.cbegin(), iterator)), line(line) {}
 
   constexpr SourceLocation() : source{}, index((size_t)-1), line((size_t)-1) {}
 
   constexpr inline StringViewT snippet() const {
+    // The last line may not end with a newline
     return {
         source.begin() + source.rfind(CharT{'\n'}, index) + 1,
-        source.begin() + source.find(CharT{'\n'}, index),
+        source.begin() + std::min(source.find(CharT{'\n'}, index), source.size()),
     };
   }
 
@@ -28,7 +28,7 @@ std::shared_ptr<const Node> Node::at(std::string_view path) const {
   auto token = parse_path_token(path);
 
   for (auto sequence = as<Sequence>(); auto member : sequence) {
-    if (member->id() == token) return at(path);
+    if (member->id() == token) return member->at(path);
   }
 
   return {};
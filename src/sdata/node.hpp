@@ -1,6 +1,7 @@
 #ifndef SDATA_NODE_HPP
 #define SDATA_NODE_HPP
 
+#include <cstdint>
 #include <exception>
 #include <memory>
 #include <string_view>
@@ -45,7 +46,10 @@ using Variant = std::variant<std::nullptr_t,
                              char32_t,
                              std::string,
                              std::u16string,
-                             std::u32string>;
+                             std::u32string,
+                             double,
+                             int64_t,
+                             uint64_t>;
 
 class Node : public std::enable_shared_from_this<Node> {
  public:
@@ -61,6 +65,9 @@ class Node : public std::enable_shared_from_this<Node> {
     STRING,
     STRING_UTF16,
     STRING_UTF32,
+    DOUBLE,
+    INT64,
+    UINT64,
   };
 
   template <typename CharT>
@@ -128,6 +135,9 @@ class Node : public std::enable_shared_from_this<Node> {
       case STRING: return "string";
       case STRING_UTF16: return "string-utf16";
       case STRING_UTF32: return "string-utf32";
+      case DOUBLE: return "double";
+      case INT64: return "int64";
+      case UINT64: return "uint64";
       case NIL: return "nil";
       default: return "";
     }
@@ -1,8 +1,12 @@
 #ifndef SDATA_PARSER_HPP
 #define SDATA_PARSER_HPP
 
+#include <array>
+#include <charconv>
+#include <optional>
 #include <sstream>
 #include "misc/fmt.hpp"
+#include "document.hpp"
 #include "misc/trim.hpp"
 #include "node.hpp"
 #include "scanner.hpp"
@@ -16,70 +20,268 @@ class ParserException : public CodeException<CharT> {
       : CodeException<CharT>("sdata::ParserException", description, token) {}
 };
 
+// Raises the error of a token out of the expected categories
+template <typename CharT>
+[[noreturn]] void parse_unexpected_token(const Token<CharT> &token, unsigned int expected) {
+  std::ostringstream expected_stream;
+
+  for (unsigned int i = 1; i != TOKEN_CATEGORY_MAX; i <<= 1) {
+    if (i & expected) expected_stream << "<" << token_category_name((TokenCategory)i) << ">,";
+  }
+
+  throw ParserException<CharT>{
+      fmt<char>("Expected token of type(s) [%]", expected_stream.str()),
+      token,
+  };
+}
+
+// Value of a number token, its type suffix excluded. Numbers are read in place from narrow
+// sources, and from a copy on the stack otherwise. Their format does not depend on the locale.
+template <typename T, typename CharT>
+T parse_number(const Token<CharT> &data) {
+  std::basic_string_view<CharT> digits = data.expression;
+  if (digits.back() < CharT{'0'} || digits.back() > CharT{'9'}) digits.remove_suffix(1);
+  if (digits.front() == CharT{'+'}) digits.remove_prefix(1);
+
+  std::array<char, 64> buffer{};
+  std::string copy{};
+  const char *begin = nullptr;
+
+  if constexpr (std::is_same_v<CharT, char>) {
+    begin = digits.data();
+  } else if (digits.size() <= buffer.size()) {
+    std::copy(digits.begin(), digits.end(), buffer.data());
+    begin = buffer.data();
+  } else {
+    begin = (copy = std::string(digits.begin(), digits.end())).data();
+  }
+
+  T value{};
+  auto [end, error] = std::from_chars(begin, begin + digits.size(), value);
+
+  if (error == std::errc::result_out_of_range) {
+    auto description = fmt<char>("Number out of the range of <%>", data.category);
+    throw ParserException<CharT>{description, data};
+  }
+
+  SDATA_ASSERT(error == std::errc{} && end == begin + digits.size(), "Number token is valid");
+  return value;
+}
+
+// Receives the parts of the parsed nodes in source order: the key of named nodes, then either the
+// bounds of the sequence around its members or the value. Strings are valid during the call only.
+template <typename Handler, typename CharT>
+concept ParserHandler = requires(Handler handler, std::basic_string_view<CharT> string) {
+  handler.key(string);
+  handler.begin_sequence();
+  handler.end_sequence();
+  handler.value(string);
+  handler.value(CharT{});
+  handler.value(bool{});
+  handler.value(int{});
+  handler.value(int64_t{});
+  handler.value(uint64_t{});
+  handler.value(float{});
+  handler.value(double{});
+};
+
 template <typename CharT>
 class Parser {
   using StringViewT = std::basic_string_view<CharT>;
 
  public:
-  explicit Parser(StringViewT source) : m_scanner(source) {}
+  // The source is tokenized at once, on several threads when it is large, the parser then walks
+  // the token buffer
+  explicit Parser(StringViewT source) : m_tokens(Scanner<CharT>{source}.tokenize_parallel()) {}
+
+  // Tokens are pulled from the stream in chunks as the parser goes, the source is never held whole
+  explicit Parser(std::basic_istream<CharT> &stream)
+      : m_tokens(StringViewT{}), m_stream(std::in_place, stream) {}
 
   std::shared_ptr<Node> parse() {
-    std::shared_ptr<Node> node{};
+    NodeBuilder builder{};
+    parse_events(builder);
+    return builder.root();
+  }
+
+  // Same grammar as parse, the tree being built in the arena of a document. Viewed strings point
+  // into the source, which must outlive the document. Streamed sources are always copied.
+  Document<CharT> parse_document(DocumentStorage storage = DOCUMENT_COPY) {
+    Document<CharT> document{};
+    DocumentBuilder builder{document, m_stream ? DOCUMENT_COPY : storage};
+
+    parse_events(builder);
+    document.m_root = builder.root();
+
+    return document;
+  }
+
+  // Walks the grammar of a node without building it, the handler gets its parts as they are read
+  template <ParserHandler<CharT> Handler>
+  void parse_events(Handler &handler) {
+    parse_node(handler);
+  }
+
+ private:
+  // Builds the shared node tree from the events
+  class NodeBuilder {
+   public:
+    inline void key(StringViewT id) {
+      m_id.assign(id);
+    }
+
+    inline void begin_sequence() {
+      m_parents.push_back(add(Sequence{}));
+    }
+
+    inline void end_sequence() {
+      m_parents.pop_back();
+    }
+
+    template <typename T>
+    void value(T value) {
+      if constexpr (std::is_same_v<T, StringViewT>) {
+        add(std::basic_string<CharT>{value});
+      } else {
+        add(value);
+      }
+    }
+
+    inline std::shared_ptr<Node> root() const {
+      return m_root;
+    }
+
+   private:
+    std::shared_ptr<Node> add(Variant data) {
+      auto node = std::make_shared<Node>(StringViewT{m_id}, std::move(data));
+      m_id.clear();
+
+      if (m_parents.empty()) {
+        m_root = node;
+      } else {
+        m_parents.back()->emplace(node);
+      }
+
+      return node;
+    }
+
+    std::basic_string<CharT> m_id;  // Copied, streamed keys do not outlive the next token
+    std::vector<std::shared_ptr<Node>> m_parents;
+    std::shared_ptr<Node> m_root;
+  };
+
+  // Builds a document from the events. Members are gathered on a stack shared by all the
+  // sequences being parsed, and moved to the arena once their sequence ends.
+  class DocumentBuilder {
+    using NodeT = DocumentNode<CharT>;
+
+   public:
+    DocumentBuilder(Document<CharT> &document, DocumentStorage storage)
+        : m_arena(document.m_arena), m_storage(storage) {}
+
+    inline void key(StringViewT id) {
+      m_id = store(id);
+    }
+
+    inline void begin_sequence() {
+      m_sequences.emplace_back(m_id, m_members.size());
+      m_id = {};
+    }
+
+    void end_sequence() {
+      auto [id, base] = m_sequences.back();
+      m_sequences.pop_back();
+
+      auto members = m_arena.copy(std::span<const NodeT>{m_members}.subspan(base));
+      m_members.erase(m_members.begin() + base, m_members.end());
+      m_members.emplace_back(id, typename NodeT::Sequence{members});
+    }
+
+    template <typename T>
+    void value(T value) {
+      if constexpr (std::is_same_v<T, StringViewT>) {
+        m_members.emplace_back(m_id, store(value));
+      } else {
+        m_members.emplace_back(m_id, value);
+      }
+
+      m_id = {};
+    }
+
+    // Left alone on the stack once parsed
+    inline const NodeT *root() {
+      return m_members.empty() ? nullptr : m_arena.template create<NodeT>(m_members.front());
+    }
+
+   private:
+    inline StringViewT store(StringViewT string) {
+      return m_storage == DOCUMENT_VIEW ? string : m_arena.copy(string);
+    }
+
+    Arena &m_arena;
+    DocumentStorage m_storage;
+    StringViewT m_id{};
+    std::vector<NodeT> m_members;
+    std::vector<std::pair<StringViewT, size_t>> m_sequences;  // Identifier and first member
+  };
+
+  // Returns false at the end of the source
+  template <typename Handler>
+  bool parse_node(Handler &handler) {
     Token<CharT> token = parse_token(TOKEN_ID | TOKEN_BEG_SEQ | TOKEN_EOF), assignment{};
 
     switch (token.category) {
       case TOKEN_ID: {
-        node = std::make_shared<Node>(token.expression, nullptr);
+        handler.key(token.expression);
         assignment = parse_token(TOKEN_BEG_SEQ | TOKEN_ASSIGN);
       } break;
       case TOKEN_BEG_SEQ: {  // Anonymous node case
-        node = std::make_shared<Node>("", nullptr);
         assignment = token;
       } break;
       default: {
-        return {};
+        return false;
       };
     }
 
     if (assignment.category == TOKEN_BEG_SEQ) {
-      parse_sequence(node);
+      parse_sequence(handler);
     }
     if (assignment.category == TOKEN_ASSIGN) {
-      parse_data(node);
+      parse_data(handler);
     }
 
-    return node;
+    return true;
   }
 
- private:
-  void parse_sequence(std::shared_ptr<Node> node) {
-    node->assign(Sequence{});
+  template <typename Handler>
+  void parse_sequence(Handler &handler) {
+    handler.begin_sequence();
 
     do {
-      if (auto member = parse()) {
-        node->emplace(member);
-      }
+      parse_node(handler);
     } while (parse_token(TOKEN_SEPARATOR | TOKEN_END_SEQ).category != TOKEN_END_SEQ);
+
+    handler.end_sequence();
   }
 
-  void parse_data(std::shared_ptr<Node> node) {
+  template <typename Handler>
+  void parse_data(Handler &handler) {
     auto data = parse_token(TOKEN_DATA);
+
     switch (data.category) {
-      case TOKEN_FLOAT: {
-        *node = std::stof(std::string{data.expression.begin(), data.expression.end()});
-      } break;
-      case TOKEN_INT: {
-        *node = std::stoi(std::string{data.expression.begin(), data.expression.end()});
-      } break;
+      case TOKEN_FLOAT: handler.value(parse_number<float>(data)); break;
+      case TOKEN_DOUBLE: handler.value(parse_number<double>(data)); break;
+      case TOKEN_INT: handler.value(parse_number<int>(data)); break;
+      case TOKEN_INT64: handler.value(parse_number<int64_t>(data)); break;
+      case TOKEN_UINT64: handler.value(parse_number<uint64_t>(data)); break;
       case TOKEN_BOOL: {
-        if (data.expression == string::convert<char, CharT>("true")) *node = true;
-        if (data.expression == string::convert<char, CharT>("false")) *node = false;
+        handler.value(data.expression == string::convert<char, CharT>("true"));
       } break;
       case TOKEN_STRING: {
-        *node = std::basic_string<CharT>{trim<CharT>(data.expression, '"')};
+        handler.value(trim<CharT>(data.expression, '"'));
       } break;
       case TOKEN_CHAR: {
-        *node = CharT{data.expression.at(1)};
+        handler.value(CharT{data.expression.at(1)});
       } break;
 
       default: break;
@@ -87,7 +289,9 @@ class Parser {
   }
 
   Token<CharT> parse_token(unsigned int expected) {
-    auto token = m_scanner.tokenize();
+    // The eof token ends the buffer and is returned past it
+    auto token =
+        m_stream ? m_stream->tokenize() : m_tokens[std::min(m_next++, m_tokens.size() - 1)];
 
     if (!(expected & token.category)) {
       parse_unexpected_token(token, expected);
@@ -96,20 +300,9 @@ class Parser {
     return token;
   }
 
-  void parse_unexpected_token(Token<CharT> token, unsigned int expected) {
-    std::ostringstream expected_stream;
-
-    for (unsigned int i = 0; i != TOKEN_CATEGORY_MAX; i <<= 1) {
-      if (i & expected) expected_stream << "<" << token_category_name((TokenCategory)i) << ">,";
-    }
-
-    throw ParserException<CharT>{
-        fmt<char>("Expected token of type(s) [%]", expected_stream.str()),
-        token,
-    };
-  }
-
-  Scanner<CharT> m_scanner;
+  TokenBuffer<CharT> m_tokens;
+  size_t m_next = 0;
+  std::optional<StreamScanner<CharT>> m_stream;
 };
 
 }  // namespace sdata
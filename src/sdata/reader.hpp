@@ -0,0 +1,185 @@
+#ifndef SDATA_READER_HPP
+#define SDATA_READER_HPP
+
+#include <string>
+#include <string_view>
+#include "misc/any_of.hpp"
+#include "misc/trim.hpp"
+#include "parser.hpp"
+#include "scanner.hpp"
+
+namespace sdata {
+
+template <typename CharT>
+class ReaderException : public CodeException<CharT> {
+ public:
+  ReaderException(std::string_view description, const Token<CharT> &token)
+      : CodeException<CharT>("sdata::ReaderException", description, token) {}
+};
+
+// Pull parser over the nodes of a source, tokenized as they are read. The reader stands on one
+// node at a time: values are decoded only when asked for, and sequences are either entered or
+// skipped over by matching their braces, without reading their members. Syntax errors raise
+// ParserException as the parser does, except in skipped sequences where only braces are checked.
+//
+//   Reader<char> reader{source};
+//   while (reader.next()) {
+//     if (reader.key() == "window") reader.enter();
+//     if (reader.key() == "width") return reader.value<int>();
+//   }
+template <typename CharT>
+class Reader {
+  using StringViewT = std::basic_string_view<CharT>;
+
+ public:
+  // The source must outlive the reader, keys and string values are views into it
+  explicit Reader(StringViewT source) : m_scanner(source) {}
+
+  // Moves to the next node of the current sequence, or to the root at first. The current node is
+  // skipped if it was not entered. Returns false past the last node of the sequence, the reader
+  // then stands after the sequence, in its parent.
+  bool next() {
+    skip();
+
+    if (m_depth == 0) {
+      if (m_started) return false;
+      m_started = true;
+    } else if (!m_first && expect(TOKEN_SEPARATOR | TOKEN_END_SEQ).category == TOKEN_END_SEQ) {
+      m_depth--;
+      return false;
+    }
+
+    m_first = false;
+    m_node = expect(TOKEN_ID | TOKEN_BEG_SEQ | (m_depth == 0 ? TOKEN_EOF : TOKEN_NONE));
+
+    switch (m_node.category) {
+      case TOKEN_ID: {
+        if (expect(TOKEN_BEG_SEQ | TOKEN_ASSIGN).category == TOKEN_ASSIGN) {
+          m_value = expect(TOKEN_DATA);
+          m_state = VALUE;
+        } else {
+          m_state = SEQUENCE;
+        }
+      } break;
+      case TOKEN_BEG_SEQ: {  // Anonymous node case
+        m_state = SEQUENCE;
+      } break;
+      default: {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // Identifier of the current node, empty for anonymous sequences
+  inline StringViewT key() const {
+    return m_node.category == TOKEN_ID ? m_node.expression : StringViewT{};
+  }
+
+  inline bool is_sequence() const {
+    return m_state == SEQUENCE;
+  }
+
+  // Category of the value token of the current node, TOKEN_NONE for sequences
+  inline TokenCategory category() const {
+    return m_state == VALUE ? m_value.category : TOKEN_NONE;
+  }
+
+  // Sequences entered so far and not left yet
+  inline size_t depth() const {
+    return m_depth;
+  }
+
+  // Values are read as the type of their token, string views point into the source
+  template <typename T>
+  T value() const {
+    static_assert(value_category<T>() != TOKEN_NONE, "Values are not read as this type");
+
+    if (m_state != VALUE || m_value.category != value_category<T>()) {
+      auto description = fmt<char>("Node has no value of type <%>", value_category<T>());
+      throw ReaderException<CharT>{description, m_state == VALUE ? m_value : m_node};
+    }
+
+    if constexpr (std::is_same_v<T, bool>) {
+      return m_value.expression == string::convert<char, CharT>("true");
+    } else if constexpr (std::is_same_v<T, CharT>) {
+      return m_value.expression.at(1);
+    } else if constexpr (any_of<T, StringViewT, std::basic_string<CharT>>) {
+      return T{trim<CharT>(m_value.expression, '"')};
+    } else {
+      return parse_number<T>(m_value);
+    }
+  }
+
+  // Moves into the current sequence, next then walks its members
+  void enter() {
+    if (m_state != SEQUENCE) throw ReaderException<CharT>{"Node is not a sequence", m_node};
+
+    m_depth++;
+    m_first = true;
+    m_state = NONE;
+  }
+
+  // Skips the current node, its members are scanned but not parsed nor decoded
+  void skip() {
+    if (m_state == SEQUENCE) close();
+    m_state = NONE;
+  }
+
+  // Moves past the end of the current sequence, its remaining members are skipped as skip does.
+  // The reader then stands after the sequence, in its parent, as when next returns false.
+  void leave() {
+    if (m_depth == 0) throw ReaderException<CharT>{"Reader is in no sequence", m_node};
+
+    skip();
+    close();
+    m_depth--;
+    m_first = false;
+  }
+
+ private:
+  enum State { NONE, VALUE, SEQUENCE };
+
+  template <typename T>
+  constexpr static TokenCategory value_category() {
+    if constexpr (std::is_same_v<T, bool>) return TOKEN_BOOL;
+    if constexpr (std::is_same_v<T, CharT>) return TOKEN_CHAR;
+    if constexpr (std::is_same_v<T, int>) return TOKEN_INT;
+    if constexpr (std::is_same_v<T, int64_t>) return TOKEN_INT64;
+    if constexpr (std::is_same_v<T, uint64_t>) return TOKEN_UINT64;
+    if constexpr (std::is_same_v<T, float>) return TOKEN_FLOAT;
+    if constexpr (std::is_same_v<T, double>) return TOKEN_DOUBLE;
+    if constexpr (any_of<T, StringViewT, std::basic_string<CharT>>) return TOKEN_STRING;
+    return TOKEN_NONE;
+  }
+
+  // Scans up to the closing brace of the sequence the scanner is in, matching the braces between
+  void close() {
+    for (size_t depth = 1; depth > 0;) {
+      Token<CharT> token = m_scanner.tokenize();
+
+      if (token.category == TOKEN_BEG_SEQ) depth++;
+      if (token.category == TOKEN_END_SEQ) depth--;
+      if (token.category == TOKEN_EOF) parse_unexpected_token(token, TOKEN_END_SEQ);
+    }
+  }
+
+  Token<CharT> expect(unsigned int expected) {
+    Token<CharT> token = m_scanner.tokenize();
+    if (!(expected & token.category)) parse_unexpected_token(token, expected);
+    return token;
+  }
+
+  Scanner<CharT> m_scanner;
+  Token<CharT> m_node{};   // Identifier or opening brace of the current node
+  Token<CharT> m_value{};  // Value of the current node
+  State m_state = NONE;
+  size_t m_depth = 0;
+  bool m_started = false;  // The root was read
+  bool m_first = true;     // No node was read yet in the current sequence
+};
+
+}  // namespace sdata
+
+#endif
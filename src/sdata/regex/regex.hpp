@@ -1,41 +1,149 @@
 #ifndef SDATA_REGEX_HPP
 #define SDATA_REGEX_HPP
 
+#include "regex_cache.hpp"
+#include "regex_dfa.hpp"
+#include "regex_glushkov.hpp"
 #include "regex_graphviz.hpp"
+#include "regex_image.hpp"
+#include "regex_jit.hpp"
+#include "regex_lazy.hpp"
+#include "regex_nfa.hpp"
 #include "regex_parser.hpp"
+#include "regex_search.hpp"
 
 namespace sdata {
 
+// Patterns are compiled once per process, regexes built from the same pattern share its program
 class Regex {
  public:
-  Regex(std::string_view pattern) : m_pattern(pattern), m_automata(RegexParser{pattern}.parse()) {}
+  Regex(std::string_view pattern) : m_program(RegexCache::global().compile(pattern)) {}
 
   inline std::string_view pattern() const {
-    return m_pattern;
+    return m_program->pattern;
   }
 
   inline const RegexAutomata &automata() const {
-    return m_automata;
+    return m_program->automata;
+  }
+
+  // Empty when the pattern is matched by a lazy dfa
+  inline const RegexDfa &dfa() const {
+    return m_program->dfa;
+  }
+
+  // Dfa built while matching, null unless the full dfa exceeds RegexProgram::DFA_STATES
+  inline const RegexLazyDfa *lazy() const {
+    return m_program->lazy.get();
+  }
+
+  // Bit-parallel matcher used by match(), null when the pattern does not fit it
+  inline const RegexGlushkov *glushkov() const {
+    return m_program->glushkov ? &*m_program->glushkov : nullptr;
   }
 
   inline RegexMatch match(std::string_view expression) const {
     return match(expression.begin(), expression.end());
   }
 
+  // Small patterns run the bit-parallel matcher, other ones the dfa or the lazy dfa
   template <typename Iterator>
   inline RegexMatch match(Iterator begin, Iterator end) const {
-    return m_automata.run<Iterator>(begin, begin, end, m_automata.root());
+    if (m_program->lazy) return m_program->lazy->run(begin, end);
+    return m_program->glushkov ? m_program->glushkov->run(begin, end) : dfa().run(begin, end);
+  }
+
+  // Native matcher of the pattern, compiled on first use and shared like the program
+  inline const RegexJit &jit() const {
+    return m_program->jit();
+  }
+
+  // Simulates the automata on the expression and counts the work done on every node and edge
+  inline RegexProfile profile(std::string_view expression) const {
+    RegexProfile profile{automata()};
+    m_program->nfa->run(expression.begin(), expression.end(), {}, {&profile, 1});
+    return profile;
+  }
+
+  // Leftmost match anywhere in the expression, starting at or after from, as long as match gives
+  // it at that position
+  inline RegexMatch search(std::string_view expression, size_t from = 0) const {
+    return m_program->searcher->search(expression, from);
+  }
+
+  // Lazy range over the non-overlapping matches of the expression
+  inline RegexMatches find_all(std::string_view expression) const {
+    return {*m_program->searcher, expression};
+  }
+
+  // Simulates the automata instead of the dfa, throws RegexBudgetException past the budget
+  inline RegexMatch match(std::string_view expression, const RegexBudget &budget) const {
+    return m_program->nfa->run(expression.begin(), expression.end(), budget);
+  }
+
+ private:
+  std::shared_ptr<const RegexProgram> m_program;
+};
+
+// Pattern passed as a template argument, for regexes compiled at compile time
+template <size_t N>
+struct RegexPattern {
+  constexpr RegexPattern(const char (&pattern)[N]) {
+    std::copy_n(pattern, N, buffer);
+  }
+
+  constexpr std::string_view view() const {
+    return {buffer, N - 1};
+  }
+
+  char buffer[N];
+};
+
+// Regex compiled at compile time, its tables live in static storage
+class StaticRegex {
+ public:
+  constexpr StaticRegex(std::string_view pattern, RegexDfaView dfa)
+      : m_pattern(pattern), m_dfa(dfa) {}
+
+  constexpr std::string_view pattern() const {
+    return m_pattern;
+  }
+
+  constexpr RegexDfaView dfa() const {
+    return m_dfa;
+  }
+
+  constexpr RegexMatch match(std::string_view expression) const {
+    return match(expression.begin(), expression.end());
+  }
+
+  template <typename Iterator>
+  constexpr RegexMatch match(Iterator begin, Iterator end) const {
+    return m_dfa.run(begin, end);
   }
 
  private:
-  RegexAutomata m_automata;
   std::string_view m_pattern;
+  RegexDfaView m_dfa;
 };
 
+template <RegexPattern P>
+constexpr RegexDfa compile_regex() {
+  return RegexDfa{RegexParser{P.view()}.parse()};
+}
+
+template <RegexPattern P>
+inline constexpr auto static_regex_dfa = make_static_dfa<compile_regex<P>>();
+
+template <RegexPattern P>
+inline constexpr StaticRegex static_regex{P.view(), static_regex_dfa<P>.view()};
+
 namespace regex_literals {
 
-inline Regex operator""_re(const char *pattern, size_t) {
-  return {pattern};
+// Patterns are compiled at compile time, use Regex for patterns built at runtime
+template <RegexPattern P>
+consteval StaticRegex operator""_re() {
+  return static_regex<P>;
 }
 
 }  // namespace regex_literals
@@ -2,114 +2,263 @@
 #define SDATA_REGEX_AUTOMATA_HPP
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
 #include <iostream>
 #include <iterator>
-#include <set>
+#include <span>
 #include <string_view>
+#include <type_traits>
+#include <vector>
 #include "misc/assert.hpp"
-#include "regex_match.hpp"
 
 namespace sdata {
 
-static const char *REGEX_EPSILON = (const char *)(0x0);
-static const char *REGEX_ANY = (const char *)(0x1);
+enum RegexNodeType : uint8_t {
+  REGEX_EPSILON,
+  REGEX_ANY,
+  REGEX_CHARACTER,
+  REGEX_CLASS,
+};
+
+struct RegexState {
+  RegexNodeType type;
+  char character = '\0';  // Category token of class nodes
+  uint32_t members = 0;    // Index of class nodes in the class table
+};
+
+// Inclusive range of bytes
+struct RegexRange {
+  uint8_t first;
+  uint8_t last;
+};
+
+// Members of a character class as a bitmap of bytes, code units wider than a byte are never
+// members, as in the dfa alphabet
+struct RegexClass {
+  constexpr static size_t BITMAP = 256;
+
+  constexpr bool test(size_t unit) const {
+    return (bitmap[unit / 64] >> (unit % 64)) & 1;
+  }
+
+  constexpr void set(size_t unit) {
+    bitmap[unit / 64] |= uint64_t{1} << (unit % 64);
+  }
+
+  // Calls the function with every member of the bitmap, in ascending order
+  template <typename Function>
+  constexpr void for_each(Function function) const {
+    for (size_t word = 0; word < bitmap.size(); word++) {
+      for (uint64_t bits = bitmap[word]; bits != 0; bits &= bits - 1) {
+        function(word * 64 + std::countr_zero(bits));
+      }
+    }
+  }
+
+  std::array<uint64_t, BITMAP / 64> bitmap{};
+};
 
 struct RegexNode {
-  struct Compare {
-    inline bool operator()(const RegexNode *a, const RegexNode *b) const {
-      return a->id < b->id;
+  RegexState state;
+  uint32_t offset = 0;  // First edge in the automata edge array
+  uint32_t count = 0;
+};
+
+// Nodes and edges are stored contiguously, edges of a node are a range of the edge array (CSR).
+// Ids are indices, an automata is copied as a few flat arrays.
+class RegexAutomata {
+ public:
+  constexpr RegexAutomata() = default;
+
+  constexpr size_t insert(RegexState state,
+                          const std::vector<size_t> &ancestors,
+                          const std::vector<size_t> &edges) {
+    size_t id = size();
+    m_nodes.push_back({state, (uint32_t)m_edges.size(), 0});
+
+    for (size_t edge : edges) connect(id, edge);
+    for (size_t ancestor : ancestors) connect(ancestor, id);
+
+    return id;
+  }
+
+  // Returns the class index to store in a REGEX_CLASS state
+  constexpr uint32_t insert_class(std::span<const RegexRange> ranges) {
+    RegexClass &inserted = m_classes.emplace_back();
+
+    for (RegexRange range : ranges) {
+      for (size_t unit = range.first; unit <= range.last; unit++) inserted.set(unit);
     }
-  };
 
-  template <typename Iterator>
-  inline bool accepts(const Iterator input, const Iterator end) const {
-    return state == REGEX_EPSILON || (input != end) && (state == REGEX_ANY || *state == *input);
+    return m_classes.size() - 1;
   }
 
-  inline bool is_leaf() const {
-    return edges.empty() || (*edges.rbegin())->id <= id;
+  constexpr uint32_t insert_class(const RegexClass &members) {
+    m_classes.push_back(members);
+    return m_classes.size() - 1;
   }
 
-  std::set<RegexNode *, RegexNode::Compare> leaves() {
-    if (is_leaf()) {
-      return {this};
+  constexpr size_t merge(const RegexAutomata &automata, const std::vector<size_t> &ancestors) {
+    size_t merged = insert_automata(automata);
+
+    if (!automata.empty()) {
+      for (size_t ancestor : ancestors) connect(ancestor, merged);
     }
 
-    std::set<RegexNode *, RegexNode::Compare> edge_leaves{};
+    return merged;
+  }
+
+  constexpr void connect(size_t node, size_t edge) {
+    RegexNode &connected = m_nodes[node];
+
+    // Edges are kept sorted in place when the range ends the array, otherwise the range is moved
+    // to the end and its previous slots are left unused until the automata is compacted
+    if (connected.offset + connected.count != m_edges.size()) {
+      size_t offset = connected.offset;
+      connected.offset = m_edges.size();
 
-    for (RegexNode *edge : edges) {
-      if (edge->id > id) edge_leaves.merge(edge->leaves());
+      for (size_t i = 0; i < connected.count; i++) {
+        m_edges.push_back(m_edges[offset + i]);
+      }
     }
 
-    return edge_leaves;
+    auto edges = m_edges.begin() + connected.offset;
+    auto position = std::lower_bound(edges, m_edges.end(), edge);
+
+    if (position == m_edges.end() || *position != edge) {
+      m_edges.insert(position, edge);
+      connected.count++;
+    }
   }
 
-  const char *state;
-  std::set<RegexNode *, Compare> edges;
-  size_t id;
-};
+  // Drops the edge slots left unused by connect
+  constexpr void compact() {
+    std::vector<uint32_t> edges{};
+    edges.reserve(m_edges.size());
 
-class RegexAutomata {
- public:
-  RegexAutomata() = default;
-  RegexAutomata &operator=(const RegexAutomata &) = delete;
+    for (RegexNode &node : m_nodes) {
+      auto begin = m_edges.begin() + node.offset;
+      node.offset = edges.size();
+      edges.insert(edges.end(), begin, begin + node.count);
+    }
 
-  RegexAutomata(const RegexAutomata &automata) {
-    insert_automata(automata);
+    m_edges = std::move(edges);
   }
 
-  ~RegexAutomata() {
-    for (RegexNode *node : m_nodes) delete node;
+  // Consuming nodes only, epsilon nodes accept nothing
+  template <typename CharT>
+  constexpr bool accepts(size_t id, CharT c) const {
+    const RegexState &state = m_nodes[id].state;
+
+    switch (state.type) {
+      case REGEX_ANY: return true;
+      case REGEX_CHARACTER: return state.character == c;
+      case REGEX_CLASS: return contains(m_classes[state.members], c);
+      default: return false;
+    }
   }
 
-  RegexNode *insert(const char *state,
-                    const std::set<RegexNode *, RegexNode::Compare> &&ancestors,
-                    const std::set<RegexNode *, RegexNode::Compare> &&edges);
+  template <typename CharT>
+  constexpr bool contains(const RegexClass &members, CharT c) const {
+    auto unit = static_cast<std::make_unsigned_t<CharT>>(c);
+    return unit < RegexClass::BITMAP && members.test(unit);
+  }
 
-  RegexNode *merge(const RegexAutomata &automata,
-                   std::set<RegexNode *, RegexNode::Compare> &&ancestors);
+  constexpr const RegexClass &character_class(size_t index) const {
+    return m_classes[index];
+  }
 
-  template <typename Iterator>
-  RegexMatch run(Iterator begin, Iterator input, const Iterator end, const RegexNode *node) const {
-    if (node != nullptr && node->accepts(input, end)) {
-      Iterator output = (node->state != REGEX_EPSILON) ? input + 1 : input;
+  constexpr const RegexNode &root() const {
+    return m_nodes.front();
+  }
 
-      for (RegexNode *edge : node->edges) {
-        if (RegexMatch match = run(begin, output, end, edge)) return match;
-      }
+  constexpr const RegexNode &node(size_t id) const {
+    return m_nodes[id];
+  }
 
-      if (node->state != REGEX_ANY && node->is_leaf()) {
-        return {true, (size_t)std::distance(begin, output)};
-      }
-    }
+  // Sorted by id, lower ids have priority
+  constexpr std::span<const uint32_t> edges(size_t id) const {
+    return {m_edges.data() + m_nodes[id].offset, m_nodes[id].count};
+  }
 
-    return {false, (size_t)std::distance(begin, input)};
+  // Nodes without forward edges, edges going back to an ancestor loop over the automata
+  constexpr bool is_leaf(size_t id) const {
+    return m_nodes[id].count == 0 || edges(id).back() <= id;
   }
 
-  inline RegexNode *root() const {
-    return *m_nodes.begin();
+  // Size of the edge array, unused slots included
+  constexpr size_t edge_count() const {
+    return m_edges.size();
   }
 
-  inline const auto nodes() const {
+  constexpr const std::vector<RegexNode> &nodes() const {
     return m_nodes;
   }
 
-  inline size_t size() const {
+  constexpr size_t size() const {
     return m_nodes.size();
   }
 
-  inline bool empty() const {
+  constexpr bool empty() const {
     return m_nodes.empty();
   }
 
-  inline std::set<RegexNode *, RegexNode::Compare> leaves() {
-    return root() != nullptr ? root()->leaves() : std::set<RegexNode *, RegexNode::Compare>{};
+  // Leaves reachable from the given node, sorted by id
+  constexpr std::vector<size_t> leaves(size_t from = 0) const {
+    std::vector<size_t> leaves{}, stack{};
+    std::vector<bool> visited(size(), false);
+
+    if (!empty()) stack.push_back(from);
+
+    while (!stack.empty()) {
+      size_t id = stack.back();
+      stack.pop_back();
+
+      if (visited[id]) continue;
+      visited[id] = true;
+
+      if (is_leaf(id)) {
+        leaves.push_back(id);
+      }
+
+      for (size_t edge : edges(id)) {
+        if (edge > id) stack.push_back(edge);
+      }
+    }
+
+    std::sort(leaves.begin(), leaves.end());
+    return leaves;
   }
 
  private:
-  RegexNode *insert_automata(const RegexAutomata &automata);
+  constexpr size_t insert_automata(const RegexAutomata &automata) {
+    // Ids are offset by the current size in order to rebuild the hierarchy, unused edge slots
+    // of the merged automata are skipped
+    size_t offset = size(), classes = m_classes.size();
+
+    m_classes.insert(m_classes.end(), automata.m_classes.begin(), automata.m_classes.end());
+
+    for (size_t id = 0; id < automata.size(); id++) {
+      RegexNode &inserted = m_nodes.emplace_back(automata.node(id));
+      inserted.offset = m_edges.size();
+      inserted.count = 0;
+
+      if (inserted.state.type == REGEX_CLASS) inserted.state.members += classes;
+
+      for (uint32_t edge : automata.edges(id)) {
+        m_edges.push_back(edge + offset);
+        inserted.count++;
+      }
+    }
+
+    return offset;
+  }
 
-  std::set<RegexNode *, RegexNode::Compare> m_nodes;
+  std::vector<RegexNode> m_nodes;
+  std::vector<uint32_t> m_edges;
+  std::vector<RegexClass> m_classes;
 };
 
 }  // namespace sdata
@@ -0,0 +1,86 @@
+#include "regex_cache.hpp"
+#include "regex_parser.hpp"
+
+namespace sdata {
+
+const RegexJit &RegexProgram::jit() const {
+  std::call_once(m_jitted, [this] {
+    m_jit = lazy ? std::make_unique<RegexJit>(*lazy) : std::make_unique<RegexJit>(dfa.view());
+  });
+  return *m_jit;
+}
+
+RegexCache &RegexCache::global() {
+  static RegexCache cache{};
+  return cache;
+}
+
+std::shared_ptr<const RegexProgram> RegexCache::compile(std::string_view pattern) {
+  {
+    std::lock_guard lock{m_mutex};
+    auto found = m_programs.find(pattern);
+
+    if (found != m_programs.end()) return hit(found->second);
+  }
+
+  // Compiled without the lock, the first program inserted wins a race on the same pattern
+  auto program = std::make_shared<RegexProgram>();
+  program->pattern = pattern;
+  program->automata = RegexParser{pattern}.parse();
+  program->nfa = std::make_unique<RegexNfa>(program->automata);
+
+  RegexDfa dfa{program->automata, RegexProgram::DFA_STATES};
+
+  if (dfa.empty()) {
+    program->lazy = std::make_unique<RegexLazyDfa>(program->automata);
+  } else {
+    program->dfa = dfa.minimize();
+  }
+
+  // Searches of exploding patterns go lazy in both directions right away
+  program->searcher = std::make_unique<RegexSearcher>(
+      program->automata, program->dfa.view(), program->lazy ? 0 : RegexProgram::DFA_STATES);
+
+  if (!program->lazy && RegexGlushkov::fits(program->automata)) {
+    RegexGlushkov glushkov{program->automata};
+    if (glushkov.equivalent(program->dfa.view())) program->glushkov = glushkov;
+  }
+
+  std::lock_guard lock{m_mutex};
+  auto [position, inserted] = m_programs.try_emplace(program->pattern, Entry{program, {}});
+  if (!inserted) return hit(position->second);
+
+  m_stats.misses++;
+  m_stats.states += dfa.size();
+  m_stats.minimized += program->dfa.size();
+  m_stats.lazy += program->lazy != nullptr;
+
+  m_uses.push_front(position->first);
+  position->second.use = m_uses.begin();
+
+  while (m_programs.size() > m_capacity) {
+    m_programs.erase(m_programs.find(m_uses.back()));
+    m_uses.pop_back();
+    m_stats.evictions++;
+  }
+
+  return program;
+}
+
+std::shared_ptr<const RegexProgram> RegexCache::hit(Entry &entry) {
+  m_stats.hits++;
+  m_uses.splice(m_uses.begin(), m_uses, entry.use);
+  return entry.program;
+}
+
+RegexCacheStats RegexCache::stats() const {
+  std::lock_guard lock{m_mutex};
+  return m_stats;
+}
+
+size_t RegexCache::size() const {
+  std::lock_guard lock{m_mutex};
+  return m_programs.size();
+}
+
+}  // namespace sdata
@@ -0,0 +1,87 @@
+#ifndef SDATA_REGEX_CACHE_HPP
+#define SDATA_REGEX_CACHE_HPP
+
+#include <algorithm>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include "regex_automata.hpp"
+#include "regex_dfa.hpp"
+#include "regex_glushkov.hpp"
+#include "regex_jit.hpp"
+#include "regex_lazy.hpp"
+#include "regex_nfa.hpp"
+#include "regex_search.hpp"
+
+namespace sdata {
+
+// Compiled form of a pattern, shared by every Regex built from the same pattern text
+struct RegexProgram {
+  // Patterns whose dfa exceeds this many states are matched by a lazy dfa instead
+  constexpr static size_t DFA_STATES = 4096;
+
+  std::string pattern;
+  RegexAutomata automata;
+  std::unique_ptr<RegexNfa> nfa;  // Runs budgeted matches and profiles
+  RegexDfa dfa;  // Empty when lazy is set
+  std::unique_ptr<RegexSearcher> searcher;
+  std::optional<RegexGlushkov> glushkov;  // Set when the pattern fits and agrees with the dfa
+  std::unique_ptr<RegexLazyDfa> lazy;
+
+  // Compiled on first use, programs are shared between threads
+  const RegexJit &jit() const;
+
+ private:
+  mutable std::once_flag m_jitted;
+  mutable std::unique_ptr<RegexJit> m_jit;
+};
+
+struct RegexCacheStats {
+  size_t hits = 0;
+  size_t misses = 0;
+  size_t states = 0;     // Dfa states of the compiled patterns before minimization
+  size_t minimized = 0;  // Dfa states of the compiled patterns after minimization
+  size_t lazy = 0;       // Patterns matched by a lazy dfa
+  size_t evictions = 0;  // Programs dropped by the cache, regexes may still hold them
+};
+
+// Process-wide cache of compiled patterns keyed by pattern text, safe to use from several
+// threads. Programs are immutable once compiled. The cache holds the most recently compiled
+// ones up to its capacity, evicted programs live on as long as a regex holds them.
+class RegexCache {
+ public:
+  constexpr static size_t CAPACITY = 1024;
+
+  explicit RegexCache(size_t capacity = CAPACITY) : m_capacity(std::max<size_t>(capacity, 1)) {}
+
+  static RegexCache &global();
+
+  // Throws RegexParserException on malformed patterns, which are not cached
+  std::shared_ptr<const RegexProgram> compile(std::string_view pattern);
+
+  RegexCacheStats stats() const;
+  size_t size() const;
+
+ private:
+  struct Entry {
+    std::shared_ptr<const RegexProgram> program;
+    std::list<std::string_view>::iterator use;
+  };
+
+  // Moves the entry to the front of the use list
+  std::shared_ptr<const RegexProgram> hit(Entry &entry);
+
+  size_t m_capacity;
+  mutable std::mutex m_mutex;
+  std::map<std::string, Entry, std::less<>> m_programs;
+  std::list<std::string_view> m_uses;  // Keys of the programs, most recently used first
+  RegexCacheStats m_stats;
+};
+
+}  // namespace sdata
+
+#endif
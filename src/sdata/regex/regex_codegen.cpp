@@ -0,0 +1,119 @@
+#include "regex_codegen.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace sdata {
+
+std::ostream &RegexCodegen::stream(std::ostream &os) const {
+  os << "template <typename Iterator>" << std::endl;
+  os << "inline RegexMatch " << m_function << "(Iterator begin, Iterator end) {" << std::endl;
+  os << "  Iterator input = begin;" << std::endl;
+
+  stream_start(os);
+
+  for (RegexDfaView::State state = 1; state < m_dfa.size(); state++) {
+    stream_state(os, state);
+  }
+
+  return os << "}" << std::endl;
+}
+
+std::string RegexCodegen::parse_column(size_t column) const {
+  if (column < 128 && std::isalnum(static_cast<int>(column))) {
+    return {'\'', static_cast<char>(column), '\''};
+  } else {
+    return std::to_string(column);
+  }
+}
+
+// The start state is entered without consuming input, its skip does not apply
+std::ostream &RegexCodegen::stream_start(std::ostream &os) const {
+  RegexDfaView::State start = m_dfa.start();
+
+  os << "  RegexMatch match{" << std::boolalpha << m_dfa.accepts(start) << ", 0, "
+     << m_dfa.accepted(start) << "u};" << std::endl;
+
+  if (start == RegexDfaView::DEAD) {
+    return os << "  return match;" << std::endl;
+  }
+
+  return os << "  goto dispatch_" << start << ";" << std::endl;
+}
+
+std::ostream &RegexCodegen::stream_state(std::ostream &os, RegexDfaView::State state) const {
+  const RegexSkip &skip = m_dfa.skip(state);
+  bool entered = false;
+
+  for (RegexDfaView::State from = 1; from < m_dfa.size() && !entered; from++) {
+    for (size_t column = 0; column < RegexDfaView::ALPHABET && !entered; column++) {
+      entered = m_dfa.next(from, column) == state;
+    }
+  }
+
+  os << std::endl;
+
+  if (entered) {
+    os << "state_" << state << ":" << std::endl;
+
+    if (skip.active()) {
+      os << "  if constexpr (std::contiguous_iterator<Iterator> && sizeof(*begin) == 1) {";
+      os << std::endl;
+      os << "    input = regex_skip(input, end, RegexSkip{{";
+
+      for (size_t i = 0; i < RegexSkip::RANGES; i++) os << (i ? ", " : "") << (int)skip.first[i];
+      os << "}, {";
+      for (size_t i = 0; i < RegexSkip::RANGES; i++) os << (i ? ", " : "") << (int)skip.last[i];
+
+      os << "}, " << (int)skip.count << ", " << std::boolalpha << skip.negated << "});";
+      os << std::endl;
+      os << "  }" << std::endl;
+    }
+
+    if (m_dfa.accepts(state)) {
+      os << "  match = {true, (size_t)std::distance(begin, input), " << m_dfa.accepted(state)
+         << "};" << std::endl;
+    }
+  }
+
+  if (state == m_dfa.start()) {
+    os << "dispatch_" << state << ":" << std::endl;
+  }
+
+  os << "  if (input == end) return match;" << std::endl;
+  return stream_switch(os, state);
+}
+
+// Columns are grouped by target, the most frequent target becomes the default case
+std::ostream &RegexCodegen::stream_switch(std::ostream &os, RegexDfaView::State state) const {
+  std::vector<size_t> frequencies(m_dfa.size(), 0);
+
+  for (size_t column = 0; column < RegexDfaView::ALPHABET; column++) {
+    frequencies[m_dfa.next(state, column)]++;
+  }
+
+  auto jump = [&](RegexDfaView::State target) {
+    return target != RegexDfaView::DEAD ? "goto state_" + std::to_string(target) : "return match";
+  };
+
+  RegexDfaView::State fallback = std::max_element(frequencies.begin(), frequencies.end()) -
+                                 frequencies.begin();
+
+  os << "  switch (RegexDfaView::column(*input++)) {" << std::endl;
+
+  for (RegexDfaView::State target = 0; target < m_dfa.size(); target++) {
+    if (target == fallback || frequencies[target] == 0) continue;
+
+    for (size_t column = 0; column < RegexDfaView::ALPHABET; column++) {
+      if (m_dfa.next(state, column) != target) continue;
+      os << "    case " << parse_column(column) << ":" << std::endl;
+    }
+
+    os << "      " << jump(target) << ";" << std::endl;
+  }
+
+  os << "    default:" << std::endl;
+  os << "      " << jump(fallback) << ";" << std::endl;
+  return os << "  }" << std::endl;
+}
+
+}  // namespace sdata
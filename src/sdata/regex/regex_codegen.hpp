@@ -0,0 +1,36 @@
+#ifndef SDATA_REGEX_CODEGEN_HPP
+#define SDATA_REGEX_CODEGEN_HPP
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include "regex_dfa.hpp"
+
+namespace sdata {
+
+// Writes a dfa as a C++ function template in the style of re2c: one label per state and one
+// switch per transition row, transitions are gotos the compiler turns into direct branches.
+// The function has the signature and the results of RegexDfaView::run.
+class RegexCodegen {
+ public:
+  RegexCodegen(RegexDfaView dfa, std::string_view function) : m_dfa(dfa), m_function(function) {}
+  std::ostream &stream(std::ostream &os) const;
+
+ private:
+  std::string parse_column(size_t column) const;
+
+  std::ostream &stream_start(std::ostream &os) const;
+  std::ostream &stream_state(std::ostream &os, RegexDfaView::State state) const;
+  std::ostream &stream_switch(std::ostream &os, RegexDfaView::State state) const;
+
+  RegexDfaView m_dfa;
+  std::string_view m_function;
+};
+
+inline std::ostream &operator<<(std::ostream &os, const RegexCodegen &codegen) {
+  return codegen.stream(os);
+}
+
+}  // namespace sdata
+
+#endif
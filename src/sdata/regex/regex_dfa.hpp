@@ -0,0 +1,743 @@
+#ifndef SDATA_REGEX_DFA_HPP
+#define SDATA_REGEX_DFA_HPP
+
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "regex_automata.hpp"
+#include "regex_match.hpp"
+#include "regex_profile.hpp"
+#include "regex_simd.hpp"
+
+namespace sdata {
+
+using RegexDfaState = uint32_t;
+
+// Non-owning view over the tables of a compiled dfa, whether built at runtime or at compile time
+class RegexDfaView {
+ public:
+  using State = RegexDfaState;
+
+  // One column per byte, code units wider than a byte share the last column
+  constexpr static size_t ALPHABET = 257;
+  constexpr static State DEAD = 0;
+  constexpr static uint32_t REJECT = UINT32_MAX;
+
+  constexpr RegexDfaView() = default;
+  constexpr RegexDfaView(const State *transitions,
+                         const uint32_t *accepts,
+                         const RegexSkip *skips,
+                         State start,
+                         size_t size)
+      : m_transitions(transitions),
+        m_accepts(accepts),
+        m_skips(skips),
+        m_start(start),
+        m_size(size) {}
+
+  template <typename CharT>
+  constexpr static size_t column(CharT c) {
+    auto unit = static_cast<std::make_unsigned_t<CharT>>(c);
+    return unit < ALPHABET - 1 ? unit : ALPHABET - 1;
+  }
+
+  template <typename Iterator>
+  constexpr RegexMatch run(Iterator begin, Iterator end) const {
+    State state = m_start;
+    RegexMatch match{accepts(state), 0, m_accepts[state]};
+
+    for (Iterator input = begin; input != end && state != DEAD;) {
+      state = m_transitions[state * ALPHABET + column(*input++)];
+
+      if constexpr (std::contiguous_iterator<Iterator> && sizeof(*begin) == 1) {
+        if (!std::is_constant_evaluated() && m_skips[state].active()) {
+          input = regex_skip(input, end, m_skips[state]);
+        }
+      }
+
+      if (accepts(state)) {
+        match = {true, (size_t)std::distance(begin, input), m_accepts[state]};
+      }
+    }
+
+    return match;
+  }
+
+  constexpr State start() const {
+    return m_start;
+  }
+
+  constexpr State next(State state, size_t column) const {
+    return m_transitions[state * ALPHABET + column];
+  }
+
+  constexpr bool accepts(State state) const {
+    return m_accepts[state] != REJECT;
+  }
+
+  // Index of the highest priority automata matching when entering the state
+  constexpr uint32_t accepted(State state) const {
+    return m_accepts[state];
+  }
+
+  constexpr size_t size() const {
+    return m_size;
+  }
+
+  constexpr const RegexSkip &skip(State state) const {
+    return m_skips[state];
+  }
+
+ private:
+  const State *m_transitions = nullptr;
+  const uint32_t *m_accepts = nullptr;
+  const RegexSkip *m_skips = nullptr;
+  State m_start = DEAD;
+  size_t m_size = 0;
+};
+
+// Threads a match cuts within its pattern
+enum RegexSemantics : uint8_t {
+  REGEX_FIRST,    // Threads of lower priority, as the backtracking automata
+  REGEX_LONGEST,  // None, the longest input of the pattern language matches
+};
+
+struct RegexThread {
+  constexpr auto operator<=>(const RegexThread &) const = default;
+
+  uint32_t pattern;
+  size_t node;
+};
+
+// Threads waiting for input, ordered by priority. Reaching a leaf cuts every thread of lower
+// priority within the same pattern, which reproduces the first match semantics of the
+// backtracking automata. Threads of other patterns keep running for the longest match.
+struct RegexClosure {
+  constexpr bool operator==(const RegexClosure &) const = default;
+
+  constexpr void push(RegexThread thread) {
+    threads.push_back(thread);
+    hash = (hash ^ (thread.node << 8 | thread.pattern)) * 0x100000001b3;
+  }
+
+  // Compared first, closures are interned by hash
+  uint64_t hash = 0xcbf29ce484222325;
+  std::vector<RegexThread> threads;
+  uint32_t accepted = RegexDfaView::REJECT;
+};
+
+class RegexClosureBuilder {
+ public:
+  using Classes = std::array<size_t, RegexDfaView::ALPHABET>;
+
+  constexpr explicit RegexClosureBuilder(std::span<const RegexAutomata *const> automatas,
+                                         RegexSemantics semantics = REGEX_FIRST)
+      : m_automatas(automatas),
+        m_semantics(semantics),
+        m_followers(automatas.size()),
+        m_routes(automatas.size()),
+        m_visited(automatas.size()),
+        m_cut(automatas.size(), 0) {
+    for (size_t pattern = 0; pattern < automatas.size(); pattern++) {
+      m_visited[pattern].resize(automatas[pattern]->size(), 0);
+      m_followers[pattern] = followers(*automatas[pattern]);
+    }
+
+    split_alphabet();
+
+    // Alphabet classes accepted by each node, a class either contains every column of an
+    // alphabet class or none of them
+    for (size_t pattern = 0; pattern < automatas.size(); pattern++) {
+      m_routes[pattern].resize(automatas[pattern]->size());
+
+      for (size_t id = 0; id < automatas[pattern]->size(); id++) {
+        if (!has_columns(automatas[pattern]->node(id))) continue;
+
+        RegexClass members = column_members(*automatas[pattern], id);
+        std::vector<bool> routed(m_class_count, false);
+
+        members.for_each([&](size_t column) {
+          if (routed[m_classes[column]]) return;
+          routed[m_classes[column]] = true;
+          m_routes[pattern][id].push_back(m_classes[column]);
+        });
+      }
+    }
+  }
+
+  constexpr RegexClosure start() {
+    reset();
+
+    for (uint32_t pattern = 0; pattern < m_automatas.size(); pattern++) {
+      if (!m_automatas[pattern]->empty()) add({pattern, 0});
+    }
+
+    return std::move(m_closure);
+  }
+
+  // Threads of the closure accepting each alphabet class, in priority order. Threads are
+  // replaced by the first node following the same way so that equal routes lead to equal closures.
+  constexpr std::vector<RegexClosure> routes(const RegexClosure &closure) const {
+    std::vector<RegexClosure> routes(m_class_count);
+
+    for (RegexThread thread : closure.threads) {
+      RegexThread follower{thread.pattern, m_followers[thread.pattern][thread.node]};
+
+      if (node(thread).state.type == REGEX_ANY) {
+        for (auto &route : routes) route.push(follower);
+      } else {
+        for (size_t route : m_routes[thread.pattern][thread.node]) routes[route].push(follower);
+      }
+    }
+
+    return routes;
+  }
+
+  // Threads of the closure accepting the column, followed one by one
+  constexpr RegexClosure step(const RegexClosure &closure, size_t column) {
+    reset();
+
+    for (RegexThread thread : closure.threads) {
+      if (m_cut[thread.pattern] == m_generation) {
+        if (!m_profiles.empty()) m_profiles[thread.pattern].cuts++;
+        continue;
+      }
+
+      if (!m_profiles.empty()) m_profiles[thread.pattern].nodes[thread.node]++;
+      if (accepts(thread, column)) follow(thread);
+    }
+
+    return std::move(m_closure);
+  }
+
+  constexpr RegexClosure step(const RegexClosure &route) {
+    reset();
+
+    for (RegexThread thread : route.threads) {
+      if (m_cut[thread.pattern] != m_generation) follow(thread);
+    }
+
+    return std::move(m_closure);
+  }
+
+  constexpr const Classes &classes() const {
+    return m_classes;
+  }
+
+  // Counts the work of the following steps, one profile per automata
+  constexpr void profile(std::span<RegexProfile> profiles) {
+    m_profiles = profiles;
+  }
+
+ private:
+  constexpr static bool has_columns(const RegexNode &node) {
+    return node.state.type == REGEX_CHARACTER || node.state.type == REGEX_CLASS;
+  }
+
+  // Columns accepted by a character or class node, the column of wide code units is never one
+  constexpr static RegexClass column_members(const RegexAutomata &automata, size_t id) {
+    const RegexState &state = automata.node(id).state;
+    RegexClass members{};
+
+    if (state.type == REGEX_CHARACTER) {
+      members.set(RegexDfaView::column(state.character));
+    } else if (state.type == REGEX_CLASS) {
+      members = automata.character_class(state.members);
+    }
+
+    return members;
+  }
+
+  // Splits the alphabet into classes of columns that no node can tell apart
+  constexpr void split_alphabet() {
+    std::array<size_t, RegexDfaView::ALPHABET> sizes{RegexDfaView::ALPHABET};
+    m_classes.fill(0);
+
+    for (const RegexAutomata *automata : m_automatas) {
+      for (size_t id = 0; id < automata->size(); id++) {
+        if (!has_columns(automata->node(id))) continue;
+
+        RegexClass members = column_members(*automata, id);
+        std::array<size_t, RegexDfaView::ALPHABET> inside{}, split{};
+
+        members.for_each([&](size_t column) { inside[m_classes[column]]++; });
+
+        // Members are moved to a new class unless they already fill their own
+        members.for_each([&](size_t column) {
+          size_t previous = m_classes[column];
+
+          if (split[previous] == 0) {
+            if (inside[previous] == sizes[previous]) return;
+
+            split[previous] = m_class_count;
+            sizes[previous] -= inside[previous];
+            sizes[m_class_count++] = inside[previous];
+          }
+
+          m_classes[column] = split[previous];
+        });
+      }
+    }
+  }
+
+  // Consuming nodes with the same edges and leafness are followed the same way. Such nodes are
+  // inserted next to each other by character classes, each one is mapped to the first of them.
+  constexpr static std::vector<size_t> followers(const RegexAutomata &automata) {
+    std::vector<size_t> followers(automata.size());
+
+    for (size_t id = 0; id < automata.size(); id++) {
+      followers[id] = id;
+      if (id == 0) continue;
+
+      const RegexNode &node = automata.node(id), &previous = automata.node(id - 1);
+
+      if (node.state.type != REGEX_EPSILON && previous.state.type != REGEX_EPSILON &&
+          (node.state.type == REGEX_ANY) == (previous.state.type == REGEX_ANY) &&
+          automata.is_leaf(id) == automata.is_leaf(id - 1) &&
+          std::ranges::equal(automata.edges(id), automata.edges(id - 1))) {
+        followers[id] = followers[id - 1];
+      }
+    }
+
+    return followers;
+  }
+
+  constexpr bool accepts(RegexThread thread, size_t column) const {
+    return node(thread).state.type == REGEX_ANY ||
+           (column < RegexClass::BITMAP &&
+            column_members(automata(thread), thread.node).test(column));
+  }
+
+  constexpr const RegexAutomata &automata(RegexThread thread) const {
+    return *m_automatas[thread.pattern];
+  }
+
+  constexpr const RegexNode &node(RegexThread thread) const {
+    return automata(thread).node(thread.node);
+  }
+
+  // Visits and cuts are stamped with a generation, no need to clear them between closures
+  constexpr void reset() {
+    m_closure = {};
+
+    if (++m_generation == 0) {
+      for (auto &visited : m_visited) std::fill(visited.begin(), visited.end(), 0);
+      std::fill(m_cut.begin(), m_cut.end(), 0);
+      m_generation++;
+    }
+  }
+
+  // Walks the epsilon closure of the node in priority order, depth first on an explicit stack:
+  // consuming nodes become threads, epsilon leaves accept once their edges are walked. Epsilon
+  // nodes are visited once per closure, a step walks each node and edge at most once.
+  constexpr void add(RegexThread thread) {
+    const RegexAutomata &walked = automata(thread);
+    std::vector<uint32_t> &visited = m_visited[thread.pattern];
+    m_stack.assign(1, thread.node << 1);
+
+    while (!m_stack.empty() && m_cut[thread.pattern] != m_generation) {
+      size_t id = m_stack.back() >> 1, leaf = m_stack.back() & 1;
+      m_stack.pop_back();
+
+      if (leaf) {
+        accept(thread.pattern);
+        continue;
+      }
+
+      if (walked.node(id).state.type != REGEX_EPSILON) {
+        push({thread.pattern, id});
+        continue;
+      }
+
+      if (visited[id] == m_generation) continue;
+      visited[id] = m_generation;
+
+      if (walked.is_leaf(id)) m_stack.push_back(id << 1 | 1);
+
+      auto edges = walked.edges(id);
+      for (auto edge = edges.rbegin(); edge != edges.rend(); edge++) {
+        if (visited[*edge] != m_generation) m_stack.push_back(size_t{*edge} << 1);
+      }
+    }
+  }
+
+  constexpr void push(RegexThread thread) {
+    if (m_cut[thread.pattern] == m_generation) return;
+    if (m_visited[thread.pattern][thread.node] == m_generation) return;
+    m_visited[thread.pattern][thread.node] = m_generation;
+    m_closure.push(thread);
+  }
+
+  constexpr void accept(uint32_t pattern) {
+    if (m_semantics == REGEX_FIRST) m_cut[pattern] = m_generation;
+    m_closure.accepted = std::min(m_closure.accepted, pattern);
+  }
+
+  constexpr void follow(RegexThread thread) {
+    const RegexNode &followed = node(thread);
+
+    for (size_t edge : automata(thread).edges(thread.node)) add({thread.pattern, edge});
+
+    if (!m_profiles.empty()) {
+      auto &edges = m_profiles[thread.pattern].edges;
+      for (size_t i = 0; i < followed.count; i++) edges[followed.offset + i]++;
+    }
+
+    if (followed.state.type != REGEX_ANY && automata(thread).is_leaf(thread.node) &&
+        m_cut[thread.pattern] != m_generation) {
+      accept(thread.pattern);
+    }
+  }
+
+  std::span<const RegexAutomata *const> m_automatas;
+  RegexSemantics m_semantics;
+  std::vector<std::vector<size_t>> m_followers;
+  std::vector<std::vector<std::vector<size_t>>> m_routes;
+  Classes m_classes{};
+  size_t m_class_count = 1;
+  RegexClosure m_closure;
+  std::vector<std::vector<uint32_t>> m_visited;
+  std::vector<uint32_t> m_cut;
+  std::vector<size_t> m_stack;  // Nodes left to walk by add, shifted over a leaf marker bit
+  uint32_t m_generation = 0;
+  std::span<RegexProfile> m_profiles;
+};
+
+// Deterministic form of a RegexAutomata, built through subset construction.
+// Every state owns a dense transition row, matching runs in a single loop.
+// Several automata can be compiled together: the longest match wins, ties go to the automata
+// given first. RegexMatch::pattern then reports which one matched.
+class RegexDfa {
+ public:
+  using State = RegexDfaState;
+
+  constexpr static size_t ALPHABET = RegexDfaView::ALPHABET;
+  constexpr static State DEAD = RegexDfaView::DEAD;
+  constexpr static uint32_t REJECT = RegexDfaView::REJECT;
+
+  constexpr RegexDfa() = default;
+
+  // Construction gives up past the state limit and leaves the dfa empty
+  constexpr explicit RegexDfa(const RegexAutomata &automata,
+                              size_t limit = SIZE_MAX,
+                              RegexSemantics semantics = REGEX_FIRST)
+      : RegexDfa(std::array<const RegexAutomata *, 1>{&automata}, limit, semantics) {}
+
+  constexpr explicit RegexDfa(std::span<const RegexAutomata *const> automatas,
+                              size_t limit = SIZE_MAX,
+                              RegexSemantics semantics = REGEX_FIRST) {
+    RegexClosureBuilder builder{automatas, semantics};
+
+    // Closures indexed by state, states sorted by closure hash for lookups
+    std::vector<RegexClosure> closures{};
+    std::vector<State> sorted{};
+
+    auto intern = [&](RegexClosure &&closure) -> State {
+      if (closure.threads.empty() && closure.accepted == REJECT) return DEAD;
+
+      auto position = std::lower_bound(
+          sorted.begin(), sorted.end(), closure.hash,
+          [&closures](State state, uint64_t hash) { return closures[state].hash < hash; });
+
+      for (auto it = position; it != sorted.end() && closures[*it].hash == closure.hash; it++) {
+        if (closures[*it] == closure) return *it;
+      }
+
+      State state = m_accepts.size();
+      m_accepts.push_back(closure.accepted);
+      m_transitions.resize(m_transitions.size() + ALPHABET, DEAD);
+      closures.push_back(std::move(closure));
+      sorted.insert(position, state);
+
+      return state;
+    };
+
+    // The dead state rejects everything and loops on itself
+    m_accepts.push_back(REJECT);
+    m_transitions.resize(ALPHABET, DEAD);
+    closures.emplace_back();
+    sorted.push_back(DEAD);
+
+    m_start = intern(builder.start());
+
+    for (State state = 1; state < closures.size(); state++) {
+      if (closures.size() > limit) {
+        *this = {};
+        return;
+      }
+
+      auto routes = builder.routes(closures[state]);
+      std::vector<size_t> order{};
+      std::vector<State> next(routes.size(), DEAD);
+
+      // Classes sharing a route are stepped once
+      for (size_t i = 0; i < routes.size(); i++) {
+        if (!routes[i].threads.empty()) order.push_back(i);
+      }
+
+      std::sort(order.begin(), order.end(), [&routes](size_t lhs, size_t rhs) {
+        return routes[lhs].hash < routes[rhs].hash;
+      });
+
+      for (size_t i = 0; i < order.size(); i++) {
+        const RegexClosure &route = routes[order[i]];
+        next[order[i]] = REJECT;
+
+        for (size_t j = i; j-- > 0 && routes[order[j]].hash == route.hash;) {
+          if (routes[order[j]] == route) {
+            next[order[i]] = next[order[j]];
+            break;
+          }
+        }
+
+        if (next[order[i]] == REJECT) next[order[i]] = intern(builder.step(route));
+      }
+
+      for (size_t column = 0; column < ALPHABET; column++) {
+        m_transitions[state * ALPHABET + column] = next[builder.classes()[column]];
+      }
+    }
+
+    find_skips();
+  }
+
+  // Merges the states no input can tell apart through Hopcroft's partition refinement. Blocks
+  // start from the accepted pattern and are split by the blocks their transitions lead to.
+  // States keep their relative order, the dead state stays first.
+  constexpr RegexDfa minimize() const {
+    size_t count = size();
+
+    // Columns are compared once per group of equal columns
+    std::vector<size_t> columns{};
+
+    for (size_t column = 0; column < ALPHABET; column++) {
+      auto equal = [&](size_t other) {
+        for (State state = 0; state < count; state++) {
+          if (next(state, other) != next(state, column)) return false;
+        }
+        return true;
+      };
+
+      if (std::none_of(columns.begin(), columns.end(), equal)) columns.push_back(column);
+    }
+
+    // Predecessors of each state by column group
+    std::vector<size_t> offsets(columns.size() * count + 1, 0);
+    std::vector<State> predecessors(columns.size() * count);
+
+    for (size_t group = 0; group < columns.size(); group++) {
+      for (State state = 0; state < count; state++) {
+        offsets[group * count + next(state, columns[group]) + 1]++;
+      }
+    }
+
+    for (size_t i = 1; i < offsets.size(); i++) offsets[i] += offsets[i - 1];
+
+    std::vector<size_t> filled(offsets.begin(), offsets.end() - 1);
+
+    for (size_t group = 0; group < columns.size(); group++) {
+      for (State state = 0; state < count; state++) {
+        predecessors[filled[group * count + next(state, columns[group])]++] = state;
+      }
+    }
+
+    // Blocks are ranges of the element array, marked elements are moved to the front of theirs
+    std::vector<State> elements(count), locations(count), blocks(count);
+    std::vector<size_t> firsts{}, lasts{}, marks{}, work{};
+    std::vector<bool> working{};
+
+    for (State state = 0; state < count; state++) elements[state] = state;
+
+    std::sort(elements.begin(), elements.end(), [this](State lhs, State rhs) {
+      return std::pair{m_accepts[lhs], lhs} < std::pair{m_accepts[rhs], rhs};
+    });
+
+    for (size_t i = 0; i < count; i++) {
+      if (i == 0 || m_accepts[elements[i]] != m_accepts[elements[i - 1]]) {
+        if (i > 0) lasts.push_back(i);
+        firsts.push_back(i);
+        marks.push_back(i);
+        work.push_back(firsts.size() - 1);
+        working.push_back(true);
+      }
+
+      locations[elements[i]] = i;
+      blocks[elements[i]] = firsts.size() - 1;
+    }
+
+    lasts.push_back(count);
+
+    auto mark = [&](State state, std::vector<size_t> &touched) {
+      size_t block = blocks[state], location = locations[state];
+      if (location < marks[block]) return;
+      if (marks[block] == firsts[block]) touched.push_back(block);
+
+      State swapped = elements[marks[block]];
+      std::swap(elements[location], elements[marks[block]]);
+      locations[swapped] = location;
+      locations[state] = marks[block]++;
+    };
+
+    auto split = [&](size_t block) {
+      if (marks[block] == lasts[block]) {
+        marks[block] = firsts[block];
+        return;
+      }
+
+      // Marked elements form the new block
+      size_t created = firsts.size();
+      firsts.push_back(firsts[block]);
+      lasts.push_back(marks[block]);
+      marks.push_back(firsts[block]);
+      working.push_back(false);
+      firsts[block] = marks[block];
+
+      for (size_t i = firsts[created]; i < lasts[created]; i++) blocks[elements[i]] = created;
+
+      size_t smaller = lasts[created] - firsts[created] <= lasts[block] - firsts[block] ? created
+                                                                                         : block;
+      size_t pushed = working[block] ? created : smaller;
+
+      if (!working[pushed]) {
+        working[pushed] = true;
+        work.push_back(pushed);
+      }
+    };
+
+    std::vector<State> splitter{};
+    std::vector<size_t> touched{};
+
+    while (!work.empty()) {
+      size_t block = work.back();
+      work.pop_back();
+      working[block] = false;
+      splitter.assign(elements.begin() + firsts[block], elements.begin() + lasts[block]);
+
+      for (size_t group = 0; group < columns.size(); group++) {
+        touched.clear();
+
+        for (State target : splitter) {
+          size_t begin = offsets[group * count + target], end = offsets[group * count + target + 1];
+          for (size_t i = begin; i < end; i++) mark(predecessors[i], touched);
+        }
+
+        for (size_t split_block : touched) split(split_block);
+      }
+    }
+
+    // A state per block, numbered by their first state
+    std::vector<State> renamed(firsts.size(), REJECT), representatives{};
+    RegexDfa minimized{};
+
+    for (State state = 0; state < count; state++) {
+      if (renamed[blocks[state]] != REJECT) continue;
+      renamed[blocks[state]] = representatives.size();
+      representatives.push_back(state);
+    }
+
+    minimized.m_accepts.resize(representatives.size());
+    minimized.m_transitions.resize(representatives.size() * ALPHABET);
+
+    for (State state = 0; state < representatives.size(); state++) {
+      minimized.m_accepts[state] = m_accepts[representatives[state]];
+
+      for (size_t column = 0; column < ALPHABET; column++) {
+        minimized.m_transitions[state * ALPHABET + column] =
+            renamed[blocks[next(representatives[state], column)]];
+      }
+    }
+
+    minimized.m_start = renamed[blocks[m_start]];
+    minimized.find_skips();
+    return minimized;
+  }
+
+  template <typename Iterator>
+  constexpr RegexMatch run(Iterator begin, Iterator end) const {
+    return view().run(begin, end);
+  }
+
+  constexpr RegexDfaView view() const {
+    return {m_transitions.data(), m_accepts.data(), m_skips.data(), m_start, size()};
+  }
+
+  constexpr State next(State state, size_t column) const {
+    return m_transitions[state * ALPHABET + column];
+  }
+
+  constexpr State start() const {
+    return m_start;
+  }
+
+  constexpr const std::vector<State> &transitions() const {
+    return m_transitions;
+  }
+
+  constexpr const std::vector<uint32_t> &accepts() const {
+    return m_accepts;
+  }
+
+  constexpr const std::vector<RegexSkip> &skips() const {
+    return m_skips;
+  }
+
+  constexpr size_t size() const {
+    return m_accepts.size();
+  }
+
+  constexpr bool empty() const {
+    return m_accepts.empty();
+  }
+
+ private:
+  // States looping on runs of bytes skip them with simd kernels
+  constexpr void find_skips() {
+    m_skips.assign(size(), {});
+
+    for (State state = 1; state < size(); state++) {
+      m_skips[state] = RegexSkip::of([&](size_t byte) { return next(state, byte) == state; });
+    }
+  }
+
+  std::vector<State> m_transitions;
+  std::vector<uint32_t> m_accepts;
+  std::vector<RegexSkip> m_skips;
+  State m_start = DEAD;
+};
+
+// Dfa tables stored in fixed size arrays, usable as constexpr variables
+template <size_t Size>
+class RegexStaticDfa {
+ public:
+  using State = RegexDfaState;
+
+  constexpr explicit RegexStaticDfa(const RegexDfa &dfa) : m_start(dfa.start()) {
+    std::copy(dfa.transitions().begin(), dfa.transitions().end(), m_transitions.begin());
+    std::copy(dfa.accepts().begin(), dfa.accepts().end(), m_accepts.begin());
+    std::copy(dfa.skips().begin(), dfa.skips().end(), m_skips.begin());
+  }
+
+  constexpr RegexDfaView view() const {
+    return {m_transitions.data(), m_accepts.data(), m_skips.data(), m_start, Size};
+  }
+
+ private:
+  std::array<State, Size * RegexDfaView::ALPHABET> m_transitions{};
+  std::array<uint32_t, Size> m_accepts{};
+  std::array<RegexSkip, Size> m_skips{};
+  State m_start;
+};
+
+// Runs the compile function twice: once for the table size, once to fill the tables
+template <RegexDfa (*compile)()>
+consteval auto make_static_dfa() {
+  constexpr size_t size = compile().size();
+  return RegexStaticDfa<size>{compile()};
+}
+
+}  // namespace sdata
+
+#endif
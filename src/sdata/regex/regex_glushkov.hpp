@@ -0,0 +1,189 @@
+#ifndef SDATA_REGEX_GLUSHKOV_HPP
+#define SDATA_REGEX_GLUSHKOV_HPP
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <set>
+#include <utility>
+#include <vector>
+#include "regex_automata.hpp"
+#include "regex_dfa.hpp"
+#include "regex_match.hpp"
+
+namespace sdata {
+
+// Glushkov automata of at most 64 positions (consuming nodes) simulated with bit-parallelism:
+// the active positions fit in one word, a character masks them and their follow sets are or-ed.
+// Follow sets are looked up by each byte of the consumed positions, a character always costs one
+// lookup per byte of positions of the pattern, whatever positions are active.
+// The simulation keeps every thread alive and finds the longest match, which only agrees with
+// the first match semantics of the other matchers for some patterns: see equivalent().
+class RegexGlushkov {
+ public:
+  constexpr static size_t POSITIONS = 64;
+  constexpr static size_t CHUNKS = POSITIONS / 8;
+
+  // Pairs of states explored by equivalent() before giving up
+  constexpr static size_t EQUIVALENCE_LIMIT = 4096;
+
+  constexpr static bool fits(const RegexAutomata &automata) {
+    size_t positions = 0;
+
+    for (size_t id = 0; id < automata.size(); id++) {
+      positions += automata.node(id).state.type != REGEX_EPSILON;
+    }
+
+    return !automata.empty() && positions <= POSITIONS;
+  }
+
+  constexpr explicit RegexGlushkov(const RegexAutomata &automata) {
+    SDATA_ASSERT(fits(automata), "Automata does not fit a glushkov matcher");
+    std::vector<size_t> positions(automata.size(), POSITIONS);
+
+    for (size_t id = 0; id < automata.size(); id++) {
+      if (automata.node(id).state.type == REGEX_EPSILON) continue;
+
+      positions[id] = m_size++;
+
+      for (size_t column = 0; column < RegexDfaView::ALPHABET; column++) {
+        if (accepts(automata, id, column)) m_masks[column] |= uint64_t{1} << positions[id];
+      }
+    }
+
+    std::array<uint64_t, POSITIONS> follows{};
+    std::vector<bool> visited(automata.size(), false);
+    m_first = closure(automata, positions, 0, visited, m_empty);
+
+    for (size_t id = 0; id < automata.size(); id++) {
+      if (positions[id] == POSITIONS) continue;
+
+      bool accepting = automata.node(id).state.type != REGEX_ANY && automata.is_leaf(id);
+      uint64_t follow = 0;
+      std::fill(visited.begin(), visited.end(), false);
+
+      for (size_t edge : automata.edges(id)) {
+        follow |= closure(automata, positions, edge, visited, accepting);
+      }
+
+      follows[positions[id]] = follow;
+      if (accepting) m_accepting |= uint64_t{1} << positions[id];
+    }
+
+    // Each byte value gets the union of the follow sets of its bits, from the value without its
+    // lowest bit
+    m_chunks = (m_size + 7) / 8;
+
+    for (size_t chunk = 0; chunk < m_chunks; chunk++) {
+      for (size_t byte = 1; byte < 256; byte++) {
+        m_follows[chunk][byte] =
+            m_follows[chunk][byte & (byte - 1)] | follows[8 * chunk + std::countr_zero(byte)];
+      }
+    }
+  }
+
+  template <typename Iterator>
+  constexpr RegexMatch run(Iterator begin, Iterator end) const {
+    RegexMatch match{m_empty, 0, m_empty ? 0 : RegexDfaView::REJECT};
+    uint64_t active = m_first;
+    size_t length = 0;
+
+    for (Iterator input = begin; input != end && active != 0; input++) {
+      uint64_t consumed = active & m_masks[RegexDfaView::column(*input)];
+      length++;
+
+      if (consumed & m_accepting) match = {true, length, 0};
+      active = follow(consumed);
+    }
+
+    return match;
+  }
+
+  // Whether the matcher gives the results of the dfa on every input. Both are walked together
+  // from their start states, every pair reached must agree on acceptance.
+  bool equivalent(RegexDfaView dfa) const {
+    if (dfa.accepts(dfa.start()) != m_empty) return false;
+
+    std::set<std::pair<RegexDfaView::State, uint64_t>> visited{{dfa.start(), m_first}};
+    std::vector<std::pair<RegexDfaView::State, uint64_t>> stack{{dfa.start(), m_first}};
+
+    while (!stack.empty()) {
+      auto [state, active] = stack.back();
+      stack.pop_back();
+
+      for (size_t column = 0; column < RegexDfaView::ALPHABET; column++) {
+        uint64_t consumed = active & m_masks[column];
+        RegexDfaView::State next = dfa.next(state, column);
+
+        if (dfa.accepts(next) != ((consumed & m_accepting) != 0)) return false;
+        if (next == RegexDfaView::DEAD && consumed == 0) continue;
+
+        if (visited.emplace(next, follow(consumed)).second) {
+          if (visited.size() > EQUIVALENCE_LIMIT) return false;
+          stack.push_back({next, follow(consumed)});
+        }
+      }
+    }
+
+    return true;
+  }
+
+  constexpr size_t size() const {
+    return m_size;
+  }
+
+ private:
+  constexpr static bool accepts(const RegexAutomata &automata, size_t id, size_t column) {
+    const RegexState &state = automata.node(id).state;
+
+    switch (state.type) {
+      case REGEX_ANY: return true;
+      case REGEX_CHARACTER: return RegexDfaView::column(state.character) == column;
+      case REGEX_CLASS:
+        return column < RegexClass::BITMAP && automata.character_class(state.members).test(column);
+      default: return false;
+    }
+  }
+
+  // Positions reached through the epsilon closure of a node, reaching an epsilon leaf accepts
+  constexpr static uint64_t closure(const RegexAutomata &automata,
+                                    const std::vector<size_t> &positions,
+                                    size_t id,
+                                    std::vector<bool> &visited,
+                                    bool &accepting) {
+    if (visited[id]) return 0;
+    visited[id] = true;
+
+    if (positions[id] != POSITIONS) return uint64_t{1} << positions[id];
+
+    uint64_t reached = 0;
+    for (size_t edge : automata.edges(id)) {
+      reached |= closure(automata, positions, edge, visited, accepting);
+    }
+
+    if (automata.is_leaf(id)) accepting = true;
+    return reached;
+  }
+
+  constexpr uint64_t follow(uint64_t consumed) const {
+    uint64_t active = 0;
+
+    for (size_t chunk = 0; chunk < m_chunks; chunk++) {
+      active |= m_follows[chunk][consumed >> (8 * chunk) & 0xff];
+    }
+
+    return active;
+  }
+
+  std::array<uint64_t, RegexDfaView::ALPHABET> m_masks{};
+  std::array<std::array<uint64_t, 256>, CHUNKS> m_follows{};
+  uint64_t m_first = 0;
+  uint64_t m_accepting = 0;
+  bool m_empty = false;
+  size_t m_size = 0;
+  size_t m_chunks = 0;  // Bytes of positions in use
+};
+
+}  // namespace sdata
+
+#endif
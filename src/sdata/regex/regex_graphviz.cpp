@@ -1,11 +1,14 @@
 #include "regex_graphviz.hpp"
 #include <iomanip>
 #include "regex_automata.hpp"
+#include "regex_profile.hpp"
 
 namespace sdata {
 
 std::ostream &RegexGraphviz::stream(std::ostream &os) const {
-  os << CREDITS << std::endl;
+  os << CREDITS;
+  if (m_profile != nullptr) os << HEAT_CREDITS << "# cuts: " << m_profile->cuts << std::endl;
+  os << std::endl;
   os << "digraph regex_automata {" << std::endl;
 
   if (!m_automata.empty()) {
@@ -19,19 +22,21 @@ std::ostream &RegexGraphviz::stream(std::ostream &os) const {
   return os << "}";
 }
 
-std::string_view RegexGraphviz::parse_state(RegexNode *node) const {
-  if (node->state == REGEX_EPSILON) {
+std::string RegexGraphviz::parse_state(const RegexNode &node) const {
+  if (node.state.type == REGEX_EPSILON) {
     return "<$>";
-  } else if (node->state == REGEX_ANY) {
+  } else if (node.state.type == REGEX_ANY) {
     return "<^>";
-  } else if (std::isspace(*node->state)) {
+  } else if (node.state.type == REGEX_CLASS) {
+    return node.state.character != '"' ? std::string{'[', node.state.character, ']'} : "[\\\"]";
+  } else if (std::isspace(node.state.character)) {
     return "<_>";
-  } else if (!std::isprint(*node->state)) {
+  } else if (!std::isprint(node.state.character)) {
     return "<?>";
-  } else if (*node->state == '"') {
+  } else if (node.state.character == '"') {
     return "\\\"";
   } else {
-    return {node->state, 1};
+    return {node.state.character};
   }
 }
 
@@ -43,19 +48,42 @@ std::ostream &RegexGraphviz::stream_start(std::ostream &os) const {
 }
 
 std::ostream &RegexGraphviz::stream_shapes(std::ostream &os) const {
-  for (RegexNode *node : m_automata.nodes()) {
-    std::string_view shape = node->is_leaf() ? "doublecircle" : "circle";
-    os << "  " << node->id << " [shape = " << shape << "];" << std::endl;
+  for (size_t id = 0; id < m_automata.size(); id++) {
+    std::string_view shape = m_automata.is_leaf(id) ? "doublecircle" : "circle";
+    os << "  " << id << " [shape = " << shape;
+
+    // From white to red, hue saturation value colors
+    if (m_profile != nullptr) {
+      size_t count = m_profile->nodes[id], hottest = std::max<size_t>(m_profile->hottest_node(), 1);
+      os << ", style = filled, fillcolor = \"0.0 " << std::fixed << std::setprecision(3)
+         << (double)count / hottest << " 1.0\", xlabel = \"#" << count << "\"";
+    }
+
+    os << "];" << std::endl;
   }
 
   return os;
 }
 
 std::ostream &RegexGraphviz::stream_edges(std::ostream &os) const {
-  for (RegexNode *node : m_automata.nodes()) {
-    for (RegexNode *edge : node->edges) {
-      os << "  " << node->id << " -> " << edge->id;
-      os << " [label = \"" << parse_state(edge) << "\"];" << std::endl;
+  for (size_t id = 0; id < m_automata.size(); id++) {
+    const RegexNode &node = m_automata.node(id);
+
+    for (size_t i = 0; i < node.count; i++) {
+      size_t edge = m_automata.edges(id)[i];
+      os << "  " << id << " -> " << edge;
+      os << " [label = \"" << parse_state(m_automata.node(edge));
+
+      if (m_profile != nullptr) {
+        size_t count = m_profile->edges[node.offset + i];
+        size_t hottest = std::max<size_t>(m_profile->hottest_edge(), 1);
+        os << " #" << count << "\", penwidth = " << std::fixed << std::setprecision(3)
+           << 1.0 + 4.0 * count / hottest;
+      } else {
+        os << "\"";
+      }
+
+      os << "];" << std::endl;
     }
   }
 
@@ -2,10 +2,12 @@
 #define SDATA_REGEX_GRAPHVIZ_HPP
 
 #include <iostream>
+#include <string>
 
 namespace sdata {
 
 struct RegexNode;
+struct RegexProfile;
 class RegexAutomata;
 
 class RegexGraphviz {
@@ -14,20 +16,31 @@ class RegexGraphviz {
       "# <$>: epsilon state \n"
       "# <^>: any state \n"
       "# <_>: empty \n"
-      "# <?>: non-printable state \n";
+      "# <?>: non-printable state \n"
+      "# [a]: character class state \n";
+
+  constexpr static std::string_view HEAT_CREDITS =
+      "# heat: node colors and edge widths scale with the profile counts \n"
+      "# #n: threads tried on the node, followed edges and cut threads \n";
 
  public:
   RegexGraphviz(const RegexAutomata &automata) : m_automata(automata) {}
+
+  // Draws the automata as a heat map of the profile
+  RegexGraphviz(const RegexAutomata &automata, const RegexProfile &profile)
+      : m_automata(automata), m_profile(&profile) {}
+
   std::ostream &stream(std::ostream &os) const;
 
  private:
-  std::string_view parse_state(RegexNode *node) const;
+  std::string parse_state(const RegexNode &node) const;
 
   std::ostream &stream_start(std::ostream &os) const;
   std::ostream &stream_shapes(std::ostream &os) const;
   std::ostream &stream_edges(std::ostream &os) const;
 
   const RegexAutomata &m_automata;
+  const RegexProfile *m_profile = nullptr;
 };
 
 inline std::ostream &operator<<(std::ostream &os, const RegexAutomata &automata) {
@@ -0,0 +1,166 @@
+#include "regex_image.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include "misc/fmt.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SDATA_REGEX_IMAGE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sdata {
+
+namespace {
+
+using State = RegexDfaView::State;
+
+constexpr size_t ROW = RegexDfaView::ALPHABET * sizeof(State);
+
+// Bytes taken by the tables of a dfa of the given size
+constexpr size_t image_size(size_t states) {
+  return sizeof(RegexImageHeader) + states * (ROW + sizeof(uint32_t) + sizeof(RegexSkip));
+}
+
+template <typename T>
+void append(std::vector<std::byte> &image, const T *data, size_t count) {
+  auto bytes = reinterpret_cast<const std::byte *>(data);
+  image.insert(image.end(), bytes, bytes + count * sizeof(T));
+}
+
+// Named after its file in exceptions, memory images are named "memory"
+RegexDfaView read_image(std::span<const std::byte> image, std::string_view name) {
+  auto fail = [&](std::string_view description) {
+    return RegexImageException{description, name, image.size()};
+  };
+
+  RegexImageHeader header{};
+  if (image.size() < sizeof(header)) throw fail("Image is shorter than its header");
+  std::memcpy(&header, image.data(), sizeof(header));
+
+  if (header.magic != RegexImageHeader::MAGIC) throw fail("Not a dfa image");
+  if (header.version != RegexImageHeader::VERSION) throw fail("Unsupported image version");
+  if (header.order != RegexImageHeader::ORDER) throw fail("Image written in another byte order");
+  if (header.skip != sizeof(RegexSkip)) throw fail("Image written with another skip layout");
+
+  if (header.states == 0 || header.states > image.size() / ROW ||
+      image.size() != image_size(header.states)) {
+    throw fail("Image size does not match its state count");
+  }
+
+  if (reinterpret_cast<uintptr_t>(image.data()) % alignof(State) != 0) {
+    throw fail("Image is not aligned on 4 bytes");
+  }
+
+  auto transitions = reinterpret_cast<const State *>(image.data() + sizeof(header));
+  auto accepts = transitions + header.states * RegexDfaView::ALPHABET;
+  auto skips = reinterpret_cast<const RegexSkip *>(accepts + header.states);
+
+  // Out of range states would read outside the tables
+  if (header.start >= header.states) throw fail("Start state out of range");
+
+  for (size_t i = 0; i < header.states * RegexDfaView::ALPHABET; i++) {
+    if (transitions[i] >= header.states) throw fail("Transition out of range");
+  }
+
+  for (size_t state = 0; state < header.states; state++) {
+    if (accepts[state] != RegexDfaView::REJECT && accepts[state] >= header.patterns) {
+      throw fail("Accepted pattern out of range");
+    }
+
+    if (skips[state].count > RegexSkip::RANGES) throw fail("Skip with too many ranges");
+  }
+
+  return {transitions, accepts, skips, header.start, header.states};
+}
+
+}  // namespace
+
+RegexImageException::RegexImageException(std::string_view description,
+                                         std::string_view image,
+                                         size_t size)
+    : m_buffer(fmt(PATTERN, description, image, size)) {}
+
+std::vector<std::byte> regex_write_image(RegexDfaView dfa) {
+  RegexImageHeader header{};
+  header.states = dfa.size();
+  header.start = dfa.start();
+
+  for (State state = 0; state < dfa.size(); state++) {
+    if (dfa.accepts(state)) header.patterns = std::max(header.patterns, dfa.accepted(state) + 1);
+  }
+
+  std::vector<std::byte> image{};
+  image.reserve(image_size(dfa.size()));
+  append(image, &header, 1);
+
+  for (State state = 0; state < dfa.size(); state++) {
+    for (size_t column = 0; column < RegexDfaView::ALPHABET; column++) {
+      State next = dfa.next(state, column);
+      append(image, &next, 1);
+    }
+  }
+
+  for (State state = 0; state < dfa.size(); state++) {
+    uint32_t accepted = dfa.accepted(state);
+    append(image, &accepted, 1);
+  }
+
+  for (State state = 0; state < dfa.size(); state++) {
+    append(image, &dfa.skip(state), 1);
+  }
+
+  return image;
+}
+
+RegexDfaView regex_read_image(std::span<const std::byte> image) {
+  return read_image(image, "memory");
+}
+
+RegexImageFile::RegexImageFile(const std::string &path) {
+#ifdef SDATA_REGEX_IMAGE_MMAP
+  int descriptor = open(path.c_str(), O_RDONLY);
+  if (descriptor < 0) throw RegexImageException{"Image file can not be opened", path, 0};
+
+  struct stat status {};
+  if (fstat(descriptor, &status) == 0 && status.st_size > 0) {
+    m_size = status.st_size;
+    m_mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (m_mapping == MAP_FAILED) m_mapping = nullptr;
+  }
+
+  close(descriptor);
+
+  if (m_mapping != nullptr) {
+    try {
+      m_dfa = read_image({static_cast<const std::byte *>(m_mapping), m_size}, path);
+    } catch (...) {
+      munmap(m_mapping, m_size);
+      throw;
+    }
+
+    return;
+  }
+#endif
+
+  std::ifstream file{path, std::ios::binary | std::ios::ate};
+  if (!file) throw RegexImageException{"Image file can not be opened", path, 0};
+
+  m_size = file.tellg();
+  m_buffer.resize((m_size + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+  file.seekg(0);
+  file.read(reinterpret_cast<char *>(m_buffer.data()), m_size);
+
+  m_dfa = read_image({reinterpret_cast<const std::byte *>(m_buffer.data()), m_size}, path);
+}
+
+RegexImageFile::~RegexImageFile() {
+#ifdef SDATA_REGEX_IMAGE_MMAP
+  if (m_mapping != nullptr) munmap(m_mapping, m_size);
+#endif
+}
+
+}  // namespace sdata
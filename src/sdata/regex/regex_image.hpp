@@ -0,0 +1,80 @@
+#ifndef SDATA_REGEX_IMAGE_HPP
+#define SDATA_REGEX_IMAGE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <span>
+#include <string>
+#include <vector>
+#include "regex_dfa.hpp"
+#include "regex_simd.hpp"
+
+namespace sdata {
+
+class RegexImageException : public std::exception {
+  constexpr static std::string_view PATTERN =
+      "[sdata::RegexImageException raised]: %\n"
+      "with {image: \"%\", size: %}";
+
+ public:
+  RegexImageException(std::string_view description, std::string_view image, size_t size);
+
+  inline const char *what() const noexcept override {
+    return m_buffer.data();
+  }
+
+ private:
+  const std::string m_buffer;
+};
+
+// Images start with this header, followed by the transition, acceptance and skip tables laid out
+// exactly as RegexDfaView reads them. They are written in the byte order of the machine and
+// rejected by machines of another one.
+struct RegexImageHeader {
+  constexpr static std::array<char, 4> MAGIC = {'S', 'D', 'F', 'A'};
+  constexpr static uint32_t VERSION = 2;
+  constexpr static uint32_t ORDER = 0x01020304;
+
+  std::array<char, 4> magic = MAGIC;
+  uint32_t version = VERSION;
+  uint32_t order = ORDER;
+  uint32_t skip = sizeof(RegexSkip);
+  uint32_t states = 0;
+  uint32_t start = 0;
+  uint32_t patterns = 0;  // Accepting states accept one of them or REJECT
+};
+
+// Binary image of the dfa tables, multi pattern dfas such as the token lexer included
+std::vector<std::byte> regex_write_image(RegexDfaView dfa);
+
+// Validates the image and returns a view over its tables, nothing is parsed nor allocated. The
+// image must be aligned on 4 bytes, as memory mapped files and alignas(4) arrays are, and must
+// outlive the view. Throws RegexImageException on malformed images.
+RegexDfaView regex_read_image(std::span<const std::byte> image);
+
+// Image mapped read-only from a file, or read into memory where files can not be mapped
+class RegexImageFile {
+ public:
+  explicit RegexImageFile(const std::string &path);
+  ~RegexImageFile();
+
+  RegexImageFile(const RegexImageFile &) = delete;
+  RegexImageFile &operator=(const RegexImageFile &) = delete;
+
+  // Valid as long as the file is
+  inline RegexDfaView dfa() const {
+    return m_dfa;
+  }
+
+ private:
+  void *m_mapping = nullptr;
+  size_t m_size = 0;
+  std::vector<uint32_t> m_buffer;  // Word aligned copy of unmapped files
+  RegexDfaView m_dfa;
+};
+
+}  // namespace sdata
+
+#endif
@@ -0,0 +1,300 @@
+#include "regex_jit.hpp"
+
+#if defined(__x86_64__) && defined(__unix__) && (defined(__GNUC__) || defined(__clang__))
+#define SDATA_REGEX_JIT_X86 1
+#include <sys/mman.h>
+#include <array>
+#include <cstring>
+#include <initializer_list>
+#endif
+
+namespace sdata {
+
+#ifdef SDATA_REGEX_JIT_X86
+
+namespace {
+
+using State = RegexDfaView::State;
+
+// Emits the few x86-64 instructions used by the jit (System V calling convention). Registers:
+// rdi begin, rsi end, rdx accepted pattern pointer, rcx input, rax end of the match, r8d pattern
+// or REJECT while nothing matched, r9 current byte, r10 scratch. Failures are reported by r8d
+// still holding REJECT at exit, rax can't signal them as an empty match of a null view ends at
+// null.
+class Assembler {
+ public:
+  // Rows with more byte runs than this jump through a table
+  constexpr static size_t COMPARES = 6;
+
+  // Entry and dispatch labels of every state, followed by the exit label
+  explicit Assembler(size_t states) : m_labels(2 * states + 1, SIZE_MAX), m_exit(2 * states) {}
+
+  size_t entry(State state) const {
+    return 2 * state;
+  }
+
+  size_t dispatch(State state) const {
+    return 2 * state + 1;
+  }
+
+  size_t exit() const {
+    return m_exit;
+  }
+
+  size_t label() {
+    m_labels.push_back(SIZE_MAX);
+    return m_labels.size() - 1;
+  }
+
+  void bind(size_t label) {
+    m_labels[label] = m_code.size();
+  }
+
+  // mov rcx, rdi; mov rax, rdi; mov r8d, pattern
+  void start(uint32_t accepted) {
+    emit({0x48, 0x89, 0xf9});
+    emit({0x48, 0x89, 0xf8});
+    pattern(accepted);
+  }
+
+  // mov rax, rcx; mov r8d, pattern
+  void accept(uint32_t accepted) {
+    emit({0x48, 0x89, 0xc8});
+    pattern(accepted);
+  }
+
+  // Calls regex_skip(input, end, skip) when the next byte loops, the call saves live registers
+  // on a 16 bytes aligned stack
+  void skip(const RegexSkip *skip) {
+    using Kernel = const char *(*)(const char *, const char *, const RegexSkip &);
+    Kernel kernel = regex_skip;
+    size_t call = label(), done = label();
+
+    emit({0x48, 0x39, 0xf1});  // cmp rcx, rsi
+    jump({0x0f, 0x84}, done);  // je
+    load();
+
+    for (size_t i = 0; i < skip->count; i++) {
+      range(skip->first[i], skip->last[i], skip->negated ? done : call);
+    }
+
+    jump(skip->negated ? call : done);
+
+    bind(call);
+    emit({0x57, 0x56, 0x52, 0x50, 0x41, 0x50});  // push rdi, rsi, rdx, rax, r8
+    emit({0x48, 0x89, 0xcf});                    // mov rdi, rcx
+    emit({0x48, 0xba});                          // mov rdx, imm64
+    emit64(reinterpret_cast<uint64_t>(skip));
+    emit({0x49, 0xba});  // mov r10, imm64
+    emit64(reinterpret_cast<uint64_t>(kernel));
+    emit({0x41, 0xff, 0xd2});                    // call r10
+    emit({0x48, 0x89, 0xc1});                    // mov rcx, rax
+    emit({0x41, 0x58, 0x58, 0x5a, 0x5e, 0x5f});  // pop r8, rax, rdx, rsi, rdi
+    bind(done);
+  }
+
+  // cmp rcx, rsi; je exit; load; inc rcx
+  void next() {
+    emit({0x48, 0x39, 0xf1});
+    jump({0x0f, 0x84}, exit());
+    load();
+    emit({0x48, 0xff, 0xc1});
+  }
+
+  // Jumps when first <= r9d <= last
+  void range(uint8_t first, uint8_t last, size_t label) {
+    if (first == last) {
+      emit({0x41, 0x81, 0xf9});  // cmp r9d, imm32
+      emit32(first);
+      return jump({0x0f, 0x84}, label);  // je
+    }
+
+    emit({0x45, 0x8d, 0x91});  // lea r10d, [r9 - first]
+    emit32(-static_cast<uint32_t>(first));
+    emit({0x41, 0x81, 0xfa});  // cmp r10d, imm32
+    emit32(last - first);
+    jump({0x0f, 0x86}, label);  // jbe
+  }
+
+  // Jumps to the label of r9 in a table of offsets following the jump
+  void table(const std::array<size_t, 256> &labels) {
+    size_t base = label();
+
+    emit({0x4c, 0x8d, 0x15});  // lea r10, [rip + table]
+    m_fixups.push_back({m_code.size(), base, SIZE_MAX});
+    emit32(0);
+    emit({0x4f, 0x63, 0x0c, 0x8a});  // movsxd r9, dword [r10 + r9 * 4]
+    emit({0x4d, 0x01, 0xd1});        // add r9, r10
+    emit({0x41, 0xff, 0xe1});        // jmp r9
+
+    bind(base);
+
+    for (size_t label : labels) {
+      m_fixups.push_back({m_code.size(), label, base});
+      emit32(0);
+    }
+  }
+
+  void jump(size_t label) {
+    jump({0xe9}, label);
+  }
+
+  // Stores the pattern, returns the match length or UINT64_MAX
+  void ret() {
+    emit({0x44, 0x89, 0x02});                          // mov [rdx], r8d
+    emit({0x41, 0x83, 0xf8, 0xff, 0x74, 0x04});        // cmp r8d, REJECT; je +4
+    emit({0x48, 0x29, 0xf8, 0xc3});                    // sub rax, rdi; ret
+    emit({0x48, 0xc7, 0xc0, 0xff, 0xff, 0xff, 0xff});  // mov rax, -1
+    emit({0xc3});                                      // ret
+  }
+
+  // Resolves jumps and table offsets once every label is bound
+  const std::vector<uint8_t> &link() {
+    for (auto [offset, label, base] : m_fixups) {
+      int32_t relative = m_labels[label] - (base != SIZE_MAX ? m_labels[base] : offset + 4);
+      std::memcpy(m_code.data() + offset, &relative, 4);
+    }
+
+    return m_code;
+  }
+
+ private:
+  struct Fixup {
+    size_t offset;
+    size_t label;
+    size_t base;  // Offsets of jumps are relative to the next instruction
+  };
+
+  // movzx r9d, byte [rcx]
+  void load() {
+    emit({0x44, 0x0f, 0xb6, 0x09});
+  }
+
+  void pattern(uint32_t accepted) {
+    emit({0x41, 0xb8});  // mov r8d, imm32
+    emit32(accepted);
+  }
+
+  void jump(std::initializer_list<uint8_t> opcode, size_t label) {
+    emit(opcode);
+    m_fixups.push_back({m_code.size(), label, SIZE_MAX});
+    emit32(0);
+  }
+
+  void emit(std::initializer_list<uint8_t> bytes) {
+    m_code.insert(m_code.end(), bytes);
+  }
+
+  void emit32(uint32_t value) {
+    for (size_t i = 0; i < 4; i++) m_code.push_back(value >> (8 * i));
+  }
+
+  void emit64(uint64_t value) {
+    for (size_t i = 0; i < 8; i++) m_code.push_back(value >> (8 * i));
+  }
+
+  std::vector<uint8_t> m_code;
+  std::vector<size_t> m_labels;
+  std::vector<Fixup> m_fixups;
+  size_t m_exit;
+};
+
+// Transitions of a state as compares over runs of bytes, the most frequent target is jumped to
+// last. Rows with many runs jump through a table instead.
+void assemble_state(Assembler &assembler, RegexDfaView dfa, State state) {
+  std::vector<size_t> frequencies(dfa.size(), 0);
+  std::array<size_t, 256> labels{};
+  size_t runs = 0;
+
+  State fallback = dfa.next(state, 0);
+
+  for (size_t byte = 0; byte < 256; byte++) {
+    State target = dfa.next(state, byte);
+    labels[byte] = target != RegexDfaView::DEAD ? assembler.entry(target) : assembler.exit();
+
+    if (++frequencies[target] > frequencies[fallback]) fallback = target;
+  }
+
+  for (size_t byte = 0; byte < 256; byte++) {
+    if (labels[byte] != labels[fallback] && (byte == 0 || labels[byte] != labels[byte - 1])) {
+      runs++;
+    }
+  }
+
+  assembler.next();
+
+  if (runs > Assembler::COMPARES) return assembler.table(labels);
+
+  for (size_t first = 0, byte = 1; byte <= 256; byte++) {
+    if (byte < 256 && labels[byte] == labels[first]) continue;
+    if (labels[first] != labels[fallback]) assembler.range(first, byte - 1, labels[first]);
+    first = byte;
+  }
+
+  assembler.jump(labels[fallback]);
+}
+
+}  // namespace
+
+RegexJit::RegexJit(RegexDfaView dfa) : m_dfa(dfa), m_skips(dfa.size()) {
+  Assembler assembler{dfa.size()};
+
+  assembler.start(dfa.accepts(dfa.start()) ? dfa.accepted(dfa.start()) : RegexDfaView::REJECT);
+  assembler.jump(dfa.start() != RegexDfaView::DEAD ? assembler.dispatch(dfa.start())
+                                                   : assembler.exit());
+
+  // The start state is entered without consuming input, its skip and acceptance are set above
+  for (State state = 1; state < dfa.size(); state++) {
+    m_skips[state] = dfa.skip(state);
+
+    assembler.bind(assembler.entry(state));
+    if (m_skips[state].active()) assembler.skip(&m_skips[state]);
+    if (dfa.accepts(state)) assembler.accept(dfa.accepted(state));
+
+    assembler.bind(assembler.dispatch(state));
+    assemble_state(assembler, dfa, state);
+  }
+
+  assembler.bind(assembler.exit());
+  assembler.ret();
+
+  const std::vector<uint8_t> &code = assembler.link();
+
+  // Written then made executable, never both
+  void *page =
+      mmap(nullptr, code.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (page == MAP_FAILED) return;
+
+  std::memcpy(page, code.data(), code.size());
+
+  if (mprotect(page, code.size(), PROT_READ | PROT_EXEC) != 0) {
+    munmap(page, code.size());
+    return;
+  }
+
+  m_code = page;
+  m_size = code.size();
+  m_function = reinterpret_cast<Function>(page);
+}
+
+RegexJit::~RegexJit() {
+  if (m_code != nullptr) munmap(m_code, m_size);
+}
+
+#else
+
+RegexJit::RegexJit(RegexDfaView dfa) : m_dfa(dfa) {}
+
+RegexJit::~RegexJit() {}
+
+#endif
+
+RegexMatch RegexJit::run_native(const char *begin, const char *end) const {
+  uint32_t accepted = RegexDfaView::REJECT;
+  uint64_t length = m_function(begin, end, &accepted);
+
+  if (length == UINT64_MAX) return {false, 0, accepted};
+  return {true, length, accepted};
+}
+
+}  // namespace sdata
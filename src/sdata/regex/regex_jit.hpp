@@ -0,0 +1,69 @@
+#ifndef SDATA_REGEX_JIT_HPP
+#define SDATA_REGEX_JIT_HPP
+
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+#include "regex_dfa.hpp"
+#include "regex_lazy.hpp"
+#include "regex_match.hpp"
+#include "regex_simd.hpp"
+
+namespace sdata {
+
+// Native x86-64 code compiled from a dfa: every state becomes a block of compares and jumps in
+// an executable page, looping states call the simd skip kernels. Other targets, non byte inputs
+// and systems refusing executable memory fall back to the dfa tables, which must outlive the jit.
+class RegexJit {
+ public:
+  explicit RegexJit(RegexDfaView dfa);
+
+  // Lazy dfas have no tables to compile, their matches always run the lazy dfa
+  explicit RegexJit(const RegexLazyDfa &lazy) : m_lazy(&lazy) {}
+  ~RegexJit();
+
+  RegexJit(const RegexJit &) = delete;
+  RegexJit &operator=(const RegexJit &) = delete;
+
+  template <typename Iterator>
+  inline RegexMatch run(Iterator begin, Iterator end) const {
+    if (m_lazy != nullptr) return m_lazy->run(begin, end);
+
+    if constexpr (std::contiguous_iterator<Iterator> && sizeof(std::iter_value_t<Iterator>) == 1) {
+      if (m_function != nullptr) {
+        auto first = reinterpret_cast<const char *>(std::to_address(begin));
+        return run_native(first, first + (end - begin));
+      }
+    }
+
+    return m_dfa.run(begin, end);
+  }
+
+  // Whether matches run native code rather than the dfa tables
+  inline bool native() const {
+    return m_function != nullptr;
+  }
+
+  // Size of the generated code in bytes
+  inline size_t size() const {
+    return m_size;
+  }
+
+ private:
+  // Returns the match length or UINT64_MAX, stores the accepted pattern
+  using Function = uint64_t (*)(const char *begin, const char *end, uint32_t *accepted);
+
+  RegexMatch run_native(const char *begin, const char *end) const;
+
+  RegexDfaView m_dfa;
+  const RegexLazyDfa *m_lazy = nullptr;
+  std::vector<RegexSkip> m_skips;  // Read by the generated code
+  void *m_code = nullptr;
+  size_t m_size = 0;
+  Function m_function = nullptr;
+};
+
+}  // namespace sdata
+
+#endif
@@ -0,0 +1,144 @@
+#include "regex_lazy.hpp"
+#include <algorithm>
+
+namespace sdata {
+
+RegexLazyDfa::RegexLazyDfa(const RegexAutomata &automata,
+                           size_t states,
+                           RegexSemantics semantics)
+    : m_automata(automata),
+      m_automatas{&automata},
+      m_nfa(automata, semantics),
+      m_capacity(std::max(states, MIN_STATES)),
+      m_builder(m_automatas, semantics),
+      m_chunks((m_capacity + CHUNK - 1) / CHUNK),
+      m_accepts(m_capacity, RegexDfaView::REJECT) {
+  for (size_t column = 0; column < ALPHABET; column++) {
+    size_t members = m_builder.classes()[column];
+    if (members >= m_columns.size()) m_columns.resize(members + 1);
+    m_columns[members].push_back(column);
+  }
+
+  m_start_closure = m_builder.start();
+  flush();
+}
+
+size_t RegexLazyDfa::size() const {
+  std::lock_guard lock{m_build};
+  return m_closures.size();
+}
+
+RegexLazyStats RegexLazyDfa::stats() const {
+  std::lock_guard lock{m_build};
+  return {m_states, m_flushes.load(), m_fallbacks.load()};
+}
+
+RegexDfaState RegexLazyDfa::transition(State state,
+                                       size_t column,
+                                       std::shared_lock<std::shared_mutex> &shared) const {
+  RegexClosure closure{};
+
+  {
+    std::lock_guard build{m_build};
+
+    // Another match may have built it meanwhile
+    State next = row(state)[column].load(std::memory_order_relaxed);
+    if (next != UNKNOWN) return next;
+
+    closure = m_builder.step(m_closures[state], column);
+    next = DEAD;
+
+    if (!closure.threads.empty() || closure.accepted != RegexDfaView::REJECT) {
+      next = find(closure);
+      if (next == RegexDfaView::REJECT) next = insert(std::move(closure));
+    }
+
+    if (next != RegexDfaView::REJECT) {
+      // Columns of the same alphabet class share the transition
+      Row *published = m_chunks[state / CHUNK].get() + state % CHUNK * ALPHABET;
+
+      for (size_t member : m_columns[m_builder.classes()[column]]) {
+        published[member].store(next, std::memory_order_release);
+      }
+
+      return next;
+    }
+  }
+
+  // The cache is full, it is flushed once no match reads it
+  shared.unlock();
+
+  {
+    std::unique_lock exclusive{m_cache};
+    std::lock_guard build{m_build};
+
+    // Unless another match flushed it meanwhile
+    if (m_closures.size() == m_capacity && find(closure) == RegexDfaView::REJECT) flush();
+  }
+
+  shared.lock();
+  std::lock_guard build{m_build};
+
+  // Other matches may fill the cache again before the lock is taken back
+  State next = find(closure);
+  if (next == RegexDfaView::REJECT) next = insert(std::move(closure));
+  return next != RegexDfaView::REJECT ? next : UNKNOWN;
+}
+
+RegexDfaState RegexLazyDfa::find(const RegexClosure &closure) const {
+  auto position = std::lower_bound(
+      m_sorted.begin(), m_sorted.end(), closure.hash,
+      [this](State state, uint64_t hash) { return m_closures[state].hash < hash; });
+
+  for (auto it = position; it != m_sorted.end() && m_closures[*it].hash == closure.hash; it++) {
+    if (m_closures[*it] == closure) return *it;
+  }
+
+  return RegexDfaView::REJECT;
+}
+
+RegexDfaState RegexLazyDfa::insert(RegexClosure &&closure) const {
+  State state = m_closures.size();
+  if (state == m_capacity) return RegexDfaView::REJECT;
+
+  auto position = std::lower_bound(
+      m_sorted.begin(), m_sorted.end(), closure.hash,
+      [this](State state, uint64_t hash) { return m_closures[state].hash < hash; });
+
+  // The row and acceptance are written before any transition leads to the state
+  std::unique_ptr<Row[]> &chunk = m_chunks[state / CHUNK];
+  if (!chunk) chunk = std::make_unique<Row[]>(CHUNK * ALPHABET);
+
+  Row *cleared = chunk.get() + state % CHUNK * ALPHABET;
+  for (size_t column = 0; column < ALPHABET; column++) {
+    cleared[column].store(UNKNOWN, std::memory_order_relaxed);
+  }
+
+  m_accepts[state] = closure.accepted;
+  m_closures.push_back(std::move(closure));
+  m_sorted.insert(position, state);
+  m_states++;
+
+  return state;
+}
+
+void RegexLazyDfa::flush() const {
+  if (!m_closures.empty()) m_flushes.fetch_add(1, std::memory_order_relaxed);
+
+  // The dead state rejects everything and loops on itself
+  m_closures.assign(1, {});
+  m_sorted.assign(1, DEAD);
+  m_accepts[DEAD] = RegexDfaView::REJECT;
+
+  if (!m_chunks.front()) m_chunks.front() = std::make_unique<Row[]>(CHUNK * ALPHABET);
+  for (size_t column = 0; column < ALPHABET; column++) {
+    m_chunks.front()[column].store(DEAD, std::memory_order_relaxed);
+  }
+
+  m_start = DEAD;
+  if (!m_start_closure.threads.empty() || m_start_closure.accepted != RegexDfaView::REJECT) {
+    m_start = insert(RegexClosure{m_start_closure});
+  }
+}
+
+}  // namespace sdata
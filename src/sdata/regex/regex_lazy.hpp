@@ -0,0 +1,149 @@
+#ifndef SDATA_REGEX_LAZY_HPP
+#define SDATA_REGEX_LAZY_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string_view>
+#include <vector>
+#include "regex_automata.hpp"
+#include "regex_dfa.hpp"
+#include "regex_match.hpp"
+#include "regex_nfa.hpp"
+
+namespace sdata {
+
+struct RegexLazyStats {
+  size_t states = 0;     // States built since construction, flushed ones included
+  size_t flushes = 0;    // Times the full cache was emptied
+  size_t fallbacks = 0;  // Matches handed over to the nfa
+};
+
+// Dfa whose states are built while matching, for patterns whose subset construction blows up.
+// States live in a cache of bounded size which is flushed when full, steady matching runs on the
+// cached transition rows. A match flushing the cache again before it made enough progress is
+// handed over to the nfa simulation. A lazy dfa is safe to share between threads: matches read
+// the published transitions without locking, only building a state locks, and flushes wait for
+// the running matches.
+class RegexLazyDfa {
+ public:
+  using State = RegexDfaState;
+
+  constexpr static size_t ALPHABET = RegexDfaView::ALPHABET;
+  constexpr static State DEAD = RegexDfaView::DEAD;
+  constexpr static State UNKNOWN = UINT32_MAX;  // Transition not built yet
+
+  constexpr static size_t STATES = 1024;  // Default cache size, about 1 KiB per state
+  constexpr static size_t MIN_STATES = 4;  // Dead, start, current and next states
+  constexpr static size_t CHUNK = 16;      // States whose rows are allocated together
+
+  // A second flush within PROGRESS bytes per cached state falls back to the nfa
+  constexpr static size_t PROGRESS = 10;
+
+  explicit RegexLazyDfa(const RegexAutomata &automata,
+                        size_t states = STATES,
+                        RegexSemantics semantics = REGEX_FIRST);
+
+  RegexLazyDfa(const RegexLazyDfa &) = delete;
+  RegexLazyDfa &operator=(const RegexLazyDfa &) = delete;
+
+  template <typename Iterator>
+  RegexMatch run(Iterator begin, Iterator end) const {
+    std::shared_lock shared{m_cache};
+    State state = m_start;
+    RegexMatch match{accepts(state), 0, m_accepts[state]};
+    std::optional<size_t> flushed{};
+    size_t position = 0;
+
+    for (Iterator input = begin; input != end && state != DEAD; input++) {
+      size_t column = RegexDfaView::column(*input);
+      State next = row(state)[column].load(std::memory_order_acquire);
+
+      if (next == UNKNOWN) {
+        size_t flushes = m_flushes.load(std::memory_order_relaxed);
+        next = transition(state, column, shared);
+
+        if (next == UNKNOWN || m_flushes.load(std::memory_order_relaxed) != flushes) {
+          if (next == UNKNOWN || (flushed && position - *flushed < PROGRESS * m_capacity)) {
+            m_fallbacks.fetch_add(1, std::memory_order_relaxed);
+            shared.unlock();
+            return m_nfa.run(begin, end);
+          }
+
+          flushed = position;
+        }
+      }
+
+      state = next;
+      position++;
+
+      if (accepts(state)) {
+        match = {true, position, m_accepts[state]};
+      }
+    }
+
+    return match;
+  }
+
+  // States currently cached
+  size_t size() const;
+
+  RegexLazyStats stats() const;
+
+ private:
+  using Row = std::atomic<State>;
+
+  bool accepts(State state) const {
+    return m_accepts[state] != RegexDfaView::REJECT;
+  }
+
+  const Row *row(State state) const {
+    return &m_chunks[state / CHUNK][state % CHUNK * ALPHABET];
+  }
+
+  // Builds the transition of the state over the column, called with the shared lock held. A full
+  // cache is flushed under the exclusive lock, the returned state is then valid but the given
+  // one is not. Returns UNKNOWN when the state still does not fit after the flush.
+  State transition(State state, size_t column, std::shared_lock<std::shared_mutex> &shared) const;
+
+  // Returns the state of the closure, REJECT when it is not cached. Called with m_build locked.
+  State find(const RegexClosure &closure) const;
+
+  // Caches the closure, REJECT when the cache is full. Called with m_build locked.
+  State insert(RegexClosure &&closure) const;
+
+  // Empties the cache but for the dead and start states, called with both locks held
+  void flush() const;
+
+  const RegexAutomata &m_automata;
+  const RegexAutomata *m_automatas[1];
+  RegexNfa m_nfa;
+  size_t m_capacity;
+  std::vector<std::vector<size_t>> m_columns;  // Columns of each alphabet class
+
+  // Matches hold the cache shared, flushes hold it exclusively. States are built under m_build.
+  mutable std::shared_mutex m_cache;
+  mutable std::mutex m_build;
+  mutable RegexClosureBuilder m_builder;
+  mutable RegexClosure m_start_closure;
+
+  // Transition rows and acceptance are allocated once, a state is published by storing it in a
+  // transition row after its own row and acceptance are written
+  mutable std::vector<std::unique_ptr<Row[]>> m_chunks;
+  mutable std::vector<uint32_t> m_accepts;
+
+  // Closures indexed by state, states sorted by closure hash for lookups
+  mutable std::vector<RegexClosure> m_closures;
+  mutable std::vector<State> m_sorted;
+  mutable State m_start = DEAD;
+  mutable size_t m_states = 0;  // Built since construction, flushed ones included
+  mutable std::atomic<size_t> m_flushes = 0;
+  mutable std::atomic<size_t> m_fallbacks = 0;
+};
+
+}  // namespace sdata
+
+#endif
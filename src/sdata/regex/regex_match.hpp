@@ -7,12 +7,16 @@
 namespace sdata {
 
 struct RegexMatch {
-  inline operator bool() const {
+  constexpr bool operator==(const RegexMatch &) const = default;
+
+  constexpr operator bool() const {
     return matched;
   }
 
   bool matched;
   size_t length;
+  size_t pattern = 0;
+  size_t position = 0;  // Where the match starts, anchored matches start at 0
 };
 
 }  // namespace sdata
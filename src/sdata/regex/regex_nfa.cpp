@@ -0,0 +1,31 @@
+#include "regex_nfa.hpp"
+#include "misc/fmt.hpp"
+
+namespace sdata {
+
+RegexBudgetException::RegexBudgetException(std::string_view description,
+                                           size_t steps,
+                                           size_t input)
+    : m_buffer(fmt(PATTERN, description, steps, input)) {}
+
+std::unique_ptr<RegexClosureBuilder> RegexNfa::acquire(size_t &steps) const {
+  {
+    std::lock_guard lock{m_mutex};
+
+    if (!m_idle.empty()) {
+      auto builder = std::move(m_idle.back());
+      m_idle.pop_back();
+      return builder;
+    }
+  }
+
+  for (const RegexAutomata *automata : m_automatas) steps += automata->size();
+  return std::make_unique<RegexClosureBuilder>(m_builder);
+}
+
+void RegexNfa::release(std::unique_ptr<RegexClosureBuilder> builder) const {
+  std::lock_guard lock{m_mutex};
+  m_idle.push_back(std::move(builder));
+}
+
+}  // namespace sdata
@@ -0,0 +1,110 @@
+#ifndef SDATA_REGEX_NFA_HPP
+#define SDATA_REGEX_NFA_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "regex_automata.hpp"
+#include "regex_dfa.hpp"
+#include "regex_match.hpp"
+
+namespace sdata {
+
+// Limits the work of a single match, steps count the threads moved over a character
+struct RegexBudget {
+  size_t steps = SIZE_MAX;
+  std::chrono::steady_clock::duration time = std::chrono::steady_clock::duration::max();
+};
+
+class RegexBudgetException : public std::exception {
+  constexpr static std::string_view PATTERN =
+      "[sdata::RegexBudgetException raised]: %\n"
+      "with {steps: %, input: [%]}";
+
+ public:
+  RegexBudgetException(std::string_view description, size_t steps, size_t input);
+
+  inline const char *what() const noexcept override {
+    return m_buffer.data();
+  }
+
+ private:
+  const std::string m_buffer;
+};
+
+// Simulates the automata over the set of its active threads (Pike VM). Closures are walked with
+// a visited set, every character moves each thread at most once: matching runs in
+// O(input * nodes) time and constant stack, with the same results as the backtracking automata.
+// The closure builder is set up once, matches running at the same time each get a copy of it.
+class RegexNfa {
+ public:
+  // The clock is only read every TIME_CHECK characters
+  constexpr static size_t TIME_CHECK = 4096;
+
+  explicit RegexNfa(const RegexAutomata &automata, RegexSemantics semantics = REGEX_FIRST)
+      : m_automatas{&automata}, m_builder(m_automatas, semantics) {}
+
+  explicit RegexNfa(std::span<const RegexAutomata *const> automatas)
+      : m_automatas(automatas.begin(), automatas.end()), m_builder(m_automatas) {}
+
+  RegexNfa(const RegexNfa &) = delete;
+  RegexNfa &operator=(const RegexNfa &) = delete;
+
+  // Profiles, when given, count the work done on each automata. Builders copied for the match
+  // are charged to the budget, one step per node.
+  template <typename Iterator>
+  RegexMatch run(Iterator begin,
+                 Iterator end,
+                 const RegexBudget &budget = {},
+                 std::span<RegexProfile> profiles = {}) const {
+    auto start = std::chrono::steady_clock::now();
+    size_t steps = 0, position = 0;
+
+    std::unique_ptr<RegexClosureBuilder> builder = acquire(steps);
+    builder->profile(profiles);
+
+    RegexClosure closure = builder->start();
+    RegexMatch match{closure.accepted != RegexDfaView::REJECT, 0, closure.accepted};
+
+    for (Iterator input = begin; input != end && !closure.threads.empty(); input++) {
+      if ((steps += closure.threads.size()) > budget.steps) {
+        throw RegexBudgetException{"Step budget exhausted", steps, position};
+      }
+
+      if (position % TIME_CHECK == TIME_CHECK - 1 &&
+          std::chrono::steady_clock::now() - start > budget.time) {
+        throw RegexBudgetException{"Time budget exhausted", steps, position};
+      }
+
+      closure = builder->step(closure, RegexDfaView::column(*input));
+      position++;
+
+      if (closure.accepted != RegexDfaView::REJECT) {
+        match = {true, position, closure.accepted};
+      }
+    }
+
+    builder->profile({});
+    release(std::move(builder));
+    return match;
+  }
+
+ private:
+  // Idle builder, or a copy of the shared one when every builder is in use
+  std::unique_ptr<RegexClosureBuilder> acquire(size_t &steps) const;
+  void release(std::unique_ptr<RegexClosureBuilder> builder) const;
+
+  std::vector<const RegexAutomata *> m_automatas;
+  RegexClosureBuilder m_builder;
+
+  mutable std::mutex m_mutex;
+  mutable std::vector<std::unique_ptr<RegexClosureBuilder>> m_idle;
+};
+
+}  // namespace sdata
+
+#endif
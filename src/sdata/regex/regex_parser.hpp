@@ -1,9 +1,14 @@
 #ifndef SDATA_REGEX_PARSER
 #define SDATA_REGEX_PARSER
 
-#include <deque>
 #include <exception>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+#include "misc/trim.hpp"
 #include "regex_automata.hpp"
+#include "regex_category.hpp"
 
 namespace sdata {
 
@@ -25,29 +30,286 @@ class RegexParserException : public std::exception {
   const std::string m_buffer;
 };
 
+// Parsing is constexpr, patterns known at compile time are compiled during the build
+// and malformed ones are reported as compilation errors. Operands are moved through the stack and
+// sequences are parsed in place, compiling stays linear in the size of the pattern.
 class RegexParser {
  public:
-  explicit RegexParser(std::string_view pattern);
-  RegexAutomata parse();
+  constexpr explicit RegexParser(std::string_view pattern)
+      : m_pattern(trim<char>(pattern, REGEX_TOKEN_SPACE)) {}
+
+  constexpr RegexAutomata parse() {
+    for (auto token = m_pattern.begin(); token != m_pattern.end(); token++) {
+      parse_token(token);
+    }
+
+    return merge_sequences(0);
+  }
 
  private:
-  RegexAutomata merge_sequences();
-  RegexAutomata parse_operand(std::string_view::iterator &token);
-  auto parse_sequence_pattern(std::string_view::iterator &token);
-
-  void parse_token(std::string_view::iterator &token);
-  void parse_character_class(std::string_view::iterator &token);
-  void parse_any(std::string_view::iterator &token);
-  void parse_literal(std::string_view::iterator &token);
-  void parse_sequence(std::string_view::iterator &token);
-  void parse_alternative(std::string_view::iterator &token);
-  void parse_quest(std::string_view::iterator &token);
-  void parse_kleene(std::string_view::iterator &token);
-  void parse_plus(std::string_view::iterator &token);
-  void parse_wave(std::string_view::iterator &token);
-
-  std::deque<RegexAutomata> m_stack;
+  // Chains the automatas stacked above the base into the first of them. Leaves of a chain are the
+  // leaves of its last automata, they are never searched in the whole chain.
+  constexpr RegexAutomata merge_sequences(size_t base) {
+    if (m_stack.size() == base) return {};
+
+    RegexAutomata automata = std::move(m_stack[base]);
+    std::vector<size_t> leaves = automata.leaves();
+
+    for (size_t i = base + 1; i < m_stack.size(); i++) {
+      if (m_stack[i].empty()) continue;
+
+      size_t merged = automata.merge(m_stack[i], leaves);
+      leaves = m_stack[i].leaves();
+      for (size_t &leaf : leaves) leaf += merged;
+    }
+
+    m_stack.resize(base);
+    automata.compact();
+    return automata;
+  }
+
+  // Whether an operand was parsed since the beginning of the current sequence
+  constexpr bool has_operand() const {
+    return m_stack.size() > m_base && !m_stack.back().empty();
+  }
+
+  // Parses the token following an operator, returns whether it stacked a new operand
+  constexpr bool parse_next_operand(std::string_view::iterator &token) {
+    size_t size = m_stack.size();
+    parse_token(++token);
+    return m_stack.size() > size && !m_stack.back().empty();
+  }
+
+  constexpr RegexAutomata parse_operand(std::string_view::iterator &token) {
+    if (!has_operand()) {
+      throw RegexParserException{
+          "Preceding sequence is unquantifiable or missing",
+          m_pattern,
+          token,
+      };
+    }
+
+    RegexAutomata operand = std::move(m_stack.back());
+    m_stack.pop_back();
+    return operand;
+  }
+
+  // Moves the token to the next non space one
+  constexpr void skip_spaces(std::string_view::iterator &token) const {
+    while (token != m_pattern.end() && *token == REGEX_TOKEN_SPACE) token++;
+  }
+
+  constexpr void parse_token(std::string_view::iterator &token) {
+    skip_spaces(token);
+
+    // Out of range tokens
+    if (token == m_pattern.end()) return;
+
+    switch (*token) {
+      case REGEX_TOKEN_BLANK:
+      case REGEX_TOKEN_ALPHA:
+      case REGEX_TOKEN_OPERATOR:
+      case REGEX_TOKEN_NUMBER:
+      case REGEX_TOKEN_QUOTE:
+      case REGEX_TOKEN_APOSTROPHE: return parse_character_class(token);
+      case REGEX_TOKEN_ANY: return parse_any(token);
+      case REGEX_TOKEN_LITERAL: return parse_literal(token);
+      case REGEX_TOKEN_BEG_SEQ: return parse_sequence(token);
+      case REGEX_TOKEN_ALTERNATIVE: return parse_alternative(token);
+      case REGEX_TOKEN_PLUS: return parse_plus(token);
+      case REGEX_TOKEN_QUEST: return parse_quest(token);
+      case REGEX_TOKEN_KLEENE: return parse_kleene(token);
+      case REGEX_TOKEN_WAVE: return parse_wave(token);
+
+      case REGEX_TOKEN_END_SEQ:
+        // Ends the enclosing sequence, an operator missing its operand reports it
+        if (m_depth > 0) return;
+
+        throw RegexParserException{
+            "Unexpected sequence end, missing '{' opening character",
+            m_pattern,
+            token,
+        };
+
+      default:
+        throw RegexParserException{
+            "Unrecognized token in pattern",
+            m_pattern,
+            token,
+        };
+    }
+  }
+
+  constexpr static RegexRange BLANK[] = {{'\b', '\f'}, {' ', ' '}};
+  constexpr static RegexRange ALPHA[] = {{'A', 'Z'}, {'a', 'z'}};
+  constexpr static RegexRange OPERATOR[] = {
+      {'!', '!'}, {'#', '&'}, {'(', '/'}, {':', '@'}, {'[', '^'}, {'`', '`'}, {'{', '~'},
+  };
+  constexpr static RegexRange NUMBER[] = {{'0', '9'}};
+  constexpr static RegexRange QUOTE[] = {{'"', '"'}};
+  constexpr static RegexRange APOSTROPHE[] = {{'\'', '\''}};
+
+  constexpr static std::span<const RegexRange> character_class(char token) {
+    switch (token) {
+      case REGEX_TOKEN_BLANK: return BLANK;
+      case REGEX_TOKEN_ALPHA: return ALPHA;
+      case REGEX_TOKEN_OPERATOR: return OPERATOR;
+      case REGEX_TOKEN_NUMBER: return NUMBER;
+      case REGEX_TOKEN_QUOTE: return QUOTE;
+      case REGEX_TOKEN_APOSTROPHE: return APOSTROPHE;
+      default: return {};
+    }
+  }
+
+  constexpr void parse_character_class(std::string_view::iterator &token) {
+    // class_of_every_character
+
+    auto &sequence = m_stack.emplace_back();
+    uint32_t members = sequence.insert_class(character_class(*token));
+    sequence.insert({REGEX_CLASS, *token, members}, {}, {});
+  }
+
+  constexpr void parse_any(std::string_view::iterator &) {
+    m_stack.emplace_back().insert({REGEX_ANY}, {}, {});
+  }
+
+  constexpr void parse_literal(std::string_view::iterator &token) {
+    // first_character -> ... -> last_character
+
+    auto begin = token + 1, end = std::find(begin, m_pattern.end(), REGEX_TOKEN_LITERAL);
+
+    if (end == m_pattern.end()) {
+      throw RegexParserException{
+          "Unterminated string literal, missing closing character",
+          m_pattern,
+          token,
+      };
+    }
+
+    auto &sequence = m_stack.emplace_back();
+    size_t node = sequence.insert({REGEX_CHARACTER, *begin}, {}, {});
+
+    for (char c : std::string_view{begin + 1, end}) {
+      node = sequence.insert({REGEX_CHARACTER, c}, {node}, {});
+    }
+
+    token = end;
+  }
+
+  constexpr void parse_sequence(std::string_view::iterator &token) {
+    // Operands of the sequence are stacked above a new base and merged once it ends
+    auto begin = token;
+    size_t base = std::exchange(m_base, m_stack.size());
+    m_depth++;
+
+    for (skip_spaces(++token); token != m_pattern.end() && *token != REGEX_TOKEN_END_SEQ;) {
+      parse_token(token);
+      if (token != m_pattern.end()) skip_spaces(++token);
+    }
+
+    if (token == m_pattern.end()) {
+      throw RegexParserException{
+          "Unterminated sequence, missing '}' closing operator",
+          m_pattern,
+          begin,
+      };
+    }
+
+    RegexAutomata sequence = merge_sequences(m_base);
+    m_base = base;
+    m_depth--;
+    m_stack.push_back(std::move(sequence));
+  }
+
+  constexpr void parse_alternative(std::string_view::iterator &token) {
+    // root -> first_alternative
+    //      -> second_alternative
+    //      -> ...
+
+    // Chained alternatives share a single root instead of nesting the previous ones, the root is
+    // connected once all of them are merged so that its edges are appended in place
+    RegexAutomata sequence{};
+    size_t root = sequence.insert({REGEX_EPSILON}, {}, {});
+    std::vector<size_t> alternatives{};
+
+    if (!has_operand()) {
+      throw RegexParserException{"Missing left alternative", m_pattern, token};
+    }
+
+    alternatives.push_back(sequence.merge(parse_operand(token), {}));
+
+    for (auto next = token; next != m_pattern.end() && *next == REGEX_TOKEN_ALTERNATIVE;) {
+      if (token = next; !parse_next_operand(token)) {
+        throw RegexParserException{"Missing right alternative", m_pattern, token};
+      }
+
+      alternatives.push_back(sequence.merge(parse_operand(token), {}));
+      skip_spaces(++(next = token));
+    }
+
+    for (size_t alternative : alternatives) sequence.connect(root, alternative);
+    m_stack.push_back(std::move(sequence));
+  }
+
+  constexpr void parse_quest(std::string_view::iterator &token) {
+    // root -> operand -> next
+    //      -> epsilon -> next
+
+    auto operand = parse_operand(token);
+    auto &sequence = m_stack.emplace_back();
+    size_t root = sequence.insert({REGEX_EPSILON}, {}, {});
+    sequence.insert({REGEX_EPSILON}, {root}, {});
+    sequence.merge(operand, {root});
+  }
+
+  constexpr void parse_kleene(std::string_view::iterator &token) {
+    // root -> operand -> root
+    //      -> epsilon -> next
+
+    auto operand = parse_operand(token);
+    auto &sequence = m_stack.emplace_back();
+    size_t root = sequence.insert({REGEX_EPSILON}, {}, {});
+    size_t op_root = sequence.merge(operand, {root});
+    sequence.insert({REGEX_EPSILON}, {root}, {});
+
+    for (size_t leaf : sequence.leaves(op_root)) {
+      sequence.connect(leaf, root);
+    }
+  }
+
+  constexpr void parse_plus(std::string_view::iterator &token) {
+    // operand -> epsilon -> operand
+    //                    -> next
+
+    auto operand = parse_operand(token);
+    operand.insert({REGEX_EPSILON}, operand.leaves(), {0});
+    m_stack.push_back(std::move(operand));
+  }
+
+  constexpr void parse_wave(std::string_view::iterator &token) {
+    // root -> operand -> next
+    //      -> any     -> root
+
+    if (!parse_next_operand(token)) {
+      throw RegexParserException{
+          "Wave delimiter is missing or unquantifiable",
+          m_pattern,
+          token,
+      };
+    }
+
+    auto operand = parse_operand(token);
+
+    auto &sequence = m_stack.emplace_back();
+    size_t root = sequence.insert({REGEX_EPSILON}, {}, {});
+    sequence.merge(operand, {root});
+    sequence.insert({REGEX_ANY}, {root}, {root});
+  }
+
+  std::vector<RegexAutomata> m_stack;
   std::string_view m_pattern;
+  size_t m_base = 0;  // Stack size when the current sequence began
+  size_t m_depth = 0;
 };
 
 }  // namespace sdata
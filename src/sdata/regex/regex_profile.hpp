@@ -0,0 +1,36 @@
+#ifndef SDATA_REGEX_PROFILE_HPP
+#define SDATA_REGEX_PROFILE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "regex_automata.hpp"
+
+namespace sdata {
+
+// Counters filled by an instrumented simulation of an automata, drawn by RegexGraphviz.
+// Nodes count the threads tried on a character. Edges are indexed like the automata edge array
+// and count the threads leaving a consuming node through them, edges walked within epsilon
+// closures are not counted. Cuts count the threads dropped because a thread of higher priority
+// matched first: the simulation never backtracks, cut threads are its wasted work.
+struct RegexProfile {
+  RegexProfile() = default;
+  explicit RegexProfile(const RegexAutomata &automata)
+      : nodes(automata.size(), 0), edges(automata.edge_count(), 0) {}
+
+  inline size_t hottest_node() const {
+    return nodes.empty() ? 0 : *std::max_element(nodes.begin(), nodes.end());
+  }
+
+  inline size_t hottest_edge() const {
+    return edges.empty() ? 0 : *std::max_element(edges.begin(), edges.end());
+  }
+
+  std::vector<size_t> nodes;
+  std::vector<size_t> edges;
+  size_t cuts = 0;
+};
+
+}  // namespace sdata
+
+#endif
@@ -0,0 +1,182 @@
+#include "regex_search.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace sdata {
+
+RegexPrefix::RegexPrefix(RegexDfaView dfa) {
+  RegexDfaView::State state = dfa.start();
+
+  for (size_t byte = 0; byte < 256; byte++) {
+    m_starts[byte] = dfa.next(state, byte) != RegexDfaView::DEAD;
+  }
+
+  m_empty = dfa.accepts(state);
+  m_skip = RegexSkip::of([this](size_t byte) { return !m_starts[byte]; });
+
+  // Bytes every match begins with, up to the first state where a match may end
+  while (!dfa.accepts(state) && m_literal.size() < LITERAL_MAX) {
+    size_t followed = 256;
+
+    for (size_t byte = 0; byte < 256; byte++) {
+      if (dfa.next(state, byte) == RegexDfaView::DEAD) continue;
+      if (followed != 256) return;
+      followed = byte;
+    }
+
+    if (followed == 256) break;
+
+    m_literal.push_back(static_cast<char>(followed));
+    state = dfa.next(state, followed);
+
+    m_shifts.fill(m_literal.size());
+    for (size_t i = 0; i + 1 < m_literal.size(); i++) {
+      m_shifts[static_cast<uint8_t>(m_literal[i])] = m_literal.size() - 1 - i;
+    }
+  }
+}
+
+const char *RegexPrefix::find(const char *begin, const char *end) const {
+  if (m_empty || begin == end) return begin;
+  if (!m_literal.empty()) return find_literal(begin, end);
+  if (m_skip.active()) return regex_skip(begin, end, m_skip);
+
+  while (begin != end && !m_starts[static_cast<uint8_t>(*begin)]) begin++;
+  return begin;
+}
+
+const char *RegexPrefix::find_literal(const char *begin, const char *end) const {
+  if (m_literal.size() == 1) {
+    auto found = std::memchr(begin, m_literal.front(), end - begin);
+    return found != nullptr ? static_cast<const char *>(found) : end;
+  }
+
+  size_t size = m_literal.size();
+
+  for (const char *window = begin; end - window >= (std::ptrdiff_t)size;) {
+    uint8_t last = static_cast<uint8_t>(window[size - 1]);
+
+    if (last == static_cast<uint8_t>(m_literal.back()) &&
+        std::memcmp(window, m_literal.data(), size - 1) == 0) {
+      return window;
+    }
+
+    window += m_shifts[last];
+  }
+
+  return end;
+}
+
+RegexAutomata regex_unanchored(const RegexAutomata &automata) {
+  // root -> automata
+  //      -> any -> root
+
+  RegexAutomata unanchored{};
+  size_t root = unanchored.insert({REGEX_EPSILON}, {}, {});
+  unanchored.merge(automata, {root});
+  unanchored.insert({REGEX_ANY}, {root}, {root});
+  unanchored.compact();
+  return unanchored;
+}
+
+RegexAutomata regex_reversed(const RegexAutomata &automata) {
+  // root -> matching leaves -> ... reversed edges ... -> automata root -> accepting leaf
+
+  size_t count = automata.size();
+  if (count == 0) return {};
+
+  // Nodes out of reach of the root take part in no match
+  std::vector<bool> reached(count, false);
+  std::vector<size_t> stack{0};
+  reached[0] = true;
+
+  while (!stack.empty()) {
+    size_t id = stack.back();
+    stack.pop_back();
+
+    for (size_t edge : automata.edges(id)) {
+      if (reached[edge]) continue;
+      reached[edge] = true;
+      stack.push_back(edge);
+    }
+  }
+
+  // Ids are mirrored so that reversed edges still go forward and loops still go back, every
+  // node but the root follows a lower one
+  auto mirrored = [count](size_t id) { return count - id; };
+  std::vector<std::vector<size_t>> edges(count + 2);
+
+  for (size_t id = 0; id < count; id++) {
+    if (!reached[id]) continue;
+
+    for (size_t edge : automata.edges(id)) edges[mirrored(edge)].push_back(mirrored(id));
+
+    if (automata.is_leaf(id) && automata.node(id).state.type != REGEX_ANY) {
+      edges[0].push_back(mirrored(id));
+    }
+  }
+
+  edges[mirrored(0)].push_back(count + 1);
+
+  RegexAutomata reversed{};
+
+  for (size_t id = 0; id < edges.size(); id++) {
+    std::sort(edges[id].begin(), edges[id].end());
+
+    SDATA_ASSERT(id == 0 || id > count || !reached[count - id] || edges[id].back() > id,
+                 "Reversed nodes keep a forward edge");
+
+    RegexState state{REGEX_EPSILON};
+
+    if (id > 0 && id <= count) {
+      state = automata.node(count - id).state;
+      if (state.type == REGEX_CLASS) {
+        state.members = reversed.insert_class(automata.character_class(state.members));
+      }
+    }
+
+    reversed.insert(state, {}, edges[id]);
+  }
+
+  return reversed;
+}
+
+RegexSearcher::RegexSearcher(const RegexAutomata &automata, RegexDfaView dfa, size_t states)
+    : m_unanchored(regex_unanchored(automata)), m_reversed(regex_reversed(automata)) {
+  RegexDfa forward{m_unanchored, states}, backward{m_reversed, states, REGEX_LONGEST};
+
+  if (forward.empty()) {
+    m_lazy_forward = std::make_unique<RegexLazyDfa>(m_unanchored);
+  } else {
+    m_forward = forward.minimize();
+  }
+
+  if (backward.empty()) {
+    m_lazy_backward =
+        std::make_unique<RegexLazyDfa>(m_reversed, RegexLazyDfa::STATES, REGEX_LONGEST);
+  } else {
+    m_backward = backward.minimize();
+  }
+
+  if (dfa.size() > 0) m_prefix.emplace(dfa);
+}
+
+RegexMatch RegexSearcher::search(std::string_view expression, size_t from) const {
+  const char *begin = expression.data(), *end = begin + expression.size();
+  const char *first = m_prefix ? m_prefix->find(begin + from, end) : begin + from;
+
+  RegexMatch forward = m_lazy_forward ? m_lazy_forward->run(first, end) : m_forward.run(first, end);
+  if (!forward) return {false, 0};
+
+  // Runs back from the end of the match, no further than where the forward pass began
+  std::reverse_iterator<const char *> last{first + forward.length}, stop{first};
+  RegexMatch backward =
+      m_lazy_backward ? m_lazy_backward->run(last, stop) : m_backward.run(last, stop);
+
+  SDATA_ASSERT(backward, "A match ending there starts within the searched range");
+
+  size_t position = forward.length - backward.length + (first - begin);
+  return {true, backward.length, forward.pattern, position};
+}
+
+}  // namespace sdata
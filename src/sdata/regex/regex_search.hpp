@@ -0,0 +1,146 @@
+#ifndef SDATA_REGEX_SEARCH_HPP
+#define SDATA_REGEX_SEARCH_HPP
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include "regex_automata.hpp"
+#include "regex_dfa.hpp"
+#include "regex_lazy.hpp"
+#include "regex_match.hpp"
+#include "regex_simd.hpp"
+
+namespace sdata {
+
+// Positions where a match of the dfa can start. Matches beginning with a required literal are
+// looked up with memchr or Boyer-Moore-Horspool, other ones skip the bytes no match begins with.
+class RegexPrefix {
+ public:
+  constexpr static size_t LITERAL_MAX = 64;
+
+  RegexPrefix() = default;
+  explicit RegexPrefix(RegexDfaView dfa);
+
+  // First candidate position of [begin, end), end when there is none
+  const char *find(const char *begin, const char *end) const;
+
+  inline std::string_view literal() const {
+    return m_literal;
+  }
+
+ private:
+  const char *find_literal(const char *begin, const char *end) const;
+
+  std::string m_literal;
+  std::array<size_t, 256> m_shifts{};  // Horspool shifts of the literal
+  std::array<bool, 256> m_starts{};    // Bytes a match can begin with
+  RegexSkip m_skip;                     // Skips the bytes no match begins with
+  bool m_empty = false;                 // Empty matches start anywhere
+};
+
+// The automata behind a lazy any loop, matching anywhere in the input. Threads started earlier
+// have priority, a match cuts the threads started after it: the last input its dfa accepts ends
+// where the leftmost match of the automata does.
+RegexAutomata regex_unanchored(const RegexAutomata &automata);
+
+// The automata matching the reversed language, to be run with REGEX_LONGEST semantics
+RegexAutomata regex_reversed(const RegexAutomata &automata);
+
+// Searches in linear time: the unanchored automata finds where the leftmost match ends in a
+// single pass, the reversed one run backwards from there finds where it starts. Either pass runs
+// a dfa, or a lazy dfa when its dfa exceeds the state limit.
+class RegexSearcher {
+ public:
+  // The anchored dfa of the automata, when given, provides the prefix of the matches. Passes whose
+  // dfa exceeds the given number of states run a lazy dfa.
+  RegexSearcher(const RegexAutomata &automata, RegexDfaView dfa, size_t states);
+
+  RegexSearcher(const RegexSearcher &) = delete;
+  RegexSearcher &operator=(const RegexSearcher &) = delete;
+
+  // Leftmost match in the expression starting at or after from, with the length the anchored
+  // match gives at that position. The returned position is relative to the expression.
+  RegexMatch search(std::string_view expression, size_t from = 0) const;
+
+ private:
+  RegexAutomata m_unanchored, m_reversed;
+  RegexDfa m_forward, m_backward;  // Empty when the lazy dfa of their pass is set
+  std::unique_ptr<RegexLazyDfa> m_lazy_forward, m_lazy_backward;
+  std::optional<RegexPrefix> m_prefix;
+};
+
+// Successive non-overlapping matches, searched one at a time while iterating. Empty matches
+// move the search one byte further.
+class RegexMatches {
+ public:
+  class Iterator {
+   public:
+    using value_type = RegexMatch;
+    using difference_type = std::ptrdiff_t;
+
+    Iterator() = default;
+    Iterator(const RegexMatches *matches, size_t from) : m_matches(matches) {
+      search(from);
+    }
+
+    inline const RegexMatch &operator*() const {
+      return m_match;
+    }
+
+    inline const RegexMatch *operator->() const {
+      return &m_match;
+    }
+
+    inline Iterator &operator++() {
+      search(m_match.position + std::max<size_t>(m_match.length, 1));
+      return *this;
+    }
+
+    inline Iterator operator++(int) {
+      Iterator previous = *this;
+      ++*this;
+      return previous;
+    }
+
+    inline bool operator==(std::default_sentinel_t) const {
+      return !m_match.matched;
+    }
+
+   private:
+    inline void search(size_t from) {
+      const RegexMatches &matches = *m_matches;
+
+      if (from > matches.m_expression.size()) {
+        m_match = {false, 0};
+      } else {
+        m_match = matches.m_searcher->search(matches.m_expression, from);
+      }
+    }
+
+    const RegexMatches *m_matches = nullptr;
+    RegexMatch m_match{false, 0};
+  };
+
+  RegexMatches(const RegexSearcher &searcher, std::string_view expression)
+      : m_searcher(&searcher), m_expression(expression) {}
+
+  inline Iterator begin() const {
+    return {this, 0};
+  }
+
+  inline std::default_sentinel_t end() const {
+    return {};
+  }
+
+ private:
+  const RegexSearcher *m_searcher = nullptr;
+  std::string_view m_expression;
+};
+
+}  // namespace sdata
+
+#endif
@@ -0,0 +1,99 @@
+#include "regex_simd.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SDATA_REGEX_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace sdata {
+
+namespace {
+
+const char *skip_scalar(const char *begin, const char *end, const RegexSkip &skip) {
+  while (begin != end && skip.loops(static_cast<uint8_t>(*begin))) begin++;
+  return begin;
+}
+
+#ifdef SDATA_REGEX_SIMD_X86
+
+// A byte is inside [first, last] when (byte - first) <= (last - first) as unsigned bytes,
+// compared through max(offset, limit) == limit
+
+__attribute__((target("sse2"))) const char *skip_sse2(const char *begin,
+                                                     const char *end,
+                                                     const RegexSkip &skip) {
+  __m128i first[RegexSkip::RANGES], limit[RegexSkip::RANGES];
+
+  for (size_t i = 0; i < skip.count; i++) {
+    first[i] = _mm_set1_epi8(static_cast<char>(skip.first[i]));
+    limit[i] = _mm_set1_epi8(static_cast<char>(skip.last[i] - skip.first[i]));
+  }
+
+  for (; end - begin >= 16; begin += 16) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+    __m128i inside = _mm_setzero_si128();
+
+    for (size_t i = 0; i < skip.count; i++) {
+      __m128i offset = _mm_sub_epi8(bytes, first[i]);
+      inside = _mm_or_si128(inside, _mm_cmpeq_epi8(_mm_max_epu8(offset, limit[i]), limit[i]));
+    }
+
+    uint32_t loops = static_cast<uint32_t>(_mm_movemask_epi8(inside));
+    uint32_t stops = (skip.negated ? loops : ~loops) & 0xffff;
+
+    if (stops != 0) return begin + __builtin_ctz(stops);
+  }
+
+  return skip_scalar(begin, end, skip);
+}
+
+__attribute__((target("avx2"))) const char *skip_avx2(const char *begin,
+                                                     const char *end,
+                                                     const RegexSkip &skip) {
+  __m256i first[RegexSkip::RANGES], limit[RegexSkip::RANGES];
+
+  for (size_t i = 0; i < skip.count; i++) {
+    first[i] = _mm256_set1_epi8(static_cast<char>(skip.first[i]));
+    limit[i] = _mm256_set1_epi8(static_cast<char>(skip.last[i] - skip.first[i]));
+  }
+
+  for (; end - begin >= 32; begin += 32) {
+    __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+    __m256i inside = _mm256_setzero_si256();
+
+    for (size_t i = 0; i < skip.count; i++) {
+      __m256i offset = _mm256_sub_epi8(bytes, first[i]);
+      inside = _mm256_or_si256(
+          inside, _mm256_cmpeq_epi8(_mm256_max_epu8(offset, limit[i]), limit[i]));
+    }
+
+    uint32_t loops = static_cast<uint32_t>(_mm256_movemask_epi8(inside));
+    uint32_t stops = skip.negated ? loops : ~loops;
+
+    if (stops != 0) return begin + __builtin_ctz(stops);
+  }
+
+  return skip_sse2(begin, end, skip);
+}
+
+#endif
+
+using SkipKernel = const char *(*)(const char *, const char *, const RegexSkip &);
+
+SkipKernel select_kernel() {
+#ifdef SDATA_REGEX_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) return skip_avx2;
+  if (__builtin_cpu_supports("sse2")) return skip_sse2;
+#endif
+  return skip_scalar;
+}
+
+}  // namespace
+
+const char *regex_skip(const char *begin, const char *end, const RegexSkip &skip) {
+  static const SkipKernel kernel = select_kernel();
+  return kernel(begin, end, skip);
+}
+
+}  // namespace sdata
@@ -0,0 +1,78 @@
+#ifndef SDATA_REGEX_SIMD_HPP
+#define SDATA_REGEX_SIMD_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+
+namespace sdata {
+
+// Bytes a dfa state loops on, as a few byte ranges or as their complement. Runs of such bytes
+// (blanks, identifier characters, digits, string bodies) are skipped many bytes at a time.
+struct RegexSkip {
+  constexpr static size_t RANGES = 4;
+
+  // Finds the ranges of a byte set or of its complement, whichever needs fewer. The skip stays
+  // inactive when neither fits in RANGES ranges.
+  template <typename Predicate>
+  constexpr static RegexSkip of(Predicate loops) {
+    RegexSkip skips[2]{{}, {}};
+
+    for (bool negated : {false, true}) {
+      RegexSkip &skip = skips[negated];
+      skip.negated = negated;
+
+      for (size_t byte = 0; byte < 256 && skip.count <= RANGES; byte++) {
+        if (loops(byte) == negated) continue;
+
+        if (byte > 0 && loops(byte - 1) != negated && skip.count > 0) {
+          skip.last[skip.count - 1] = byte;
+        } else if (skip.count++ < RANGES) {
+          skip.first[skip.count - 1] = skip.last[skip.count - 1] = byte;
+        }
+      }
+    }
+
+    // Nothing to loop on
+    if (skips[false].count == 0) return {};
+
+    RegexSkip &skip = skips[skips[true].count > 0 && skips[true].count < skips[false].count];
+    return skip.count <= RANGES ? skip : RegexSkip{};
+  }
+
+  constexpr bool active() const {
+    return count > 0;
+  }
+
+  constexpr bool loops(uint8_t byte) const {
+    bool inside = false;
+
+    for (size_t i = 0; i < count; i++) {
+      inside |= first[i] <= byte && byte <= last[i];
+    }
+
+    return inside != negated;
+  }
+
+  std::array<uint8_t, RANGES> first{}, last{};
+  uint8_t count = 0;
+  bool negated = false;
+};
+
+// Returns the first byte of [begin, end) the skip does not loop on. Uses AVX2 or SSE2 kernels
+// when the processor supports them, a scalar loop otherwise.
+const char *regex_skip(const char *begin, const char *end, const RegexSkip &skip);
+
+// Same on contiguous ranges of bytes
+template <std::contiguous_iterator Iterator>
+  requires(sizeof(std::iter_value_t<Iterator>) == 1)
+inline Iterator regex_skip(Iterator input, Iterator end, const RegexSkip &skip) {
+  auto begin = reinterpret_cast<const char *>(std::to_address(input));
+  return input + (regex_skip(begin, begin + (end - input), skip) - begin);
+}
+
+}  // namespace sdata
+
+#endif
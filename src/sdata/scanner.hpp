@@ -1,7 +1,28 @@
 #ifndef SDATA_SCANNER_HPP
 #define SDATA_SCANNER_HPP
 
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <exception>
+#include <functional>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include "misc/code_exception.hpp"
+#include "misc/fmt.hpp"
+#include "token_buffer.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SDATA_SCANNER_DESCRIPTORS 1
+#include <unistd.h>
+#endif
+
+// Matcher generated from the token patterns by sdata_lexgen, see tools/sdata_lexgen.cpp
+#ifdef SDATA_TOKEN_LEXER_GENERATED
+#include "token_lexer_generated.hpp"
+#endif
 
 namespace sdata {
 
@@ -17,39 +38,345 @@ class Scanner {
   using StringViewT = std::basic_string_view<CharT>;
 
  public:
-  explicit Scanner(StringViewT source) : m_source(source), m_iterator(source.begin()) {}
+  explicit Scanner(StringViewT source)
+      : m_source(source), m_iterator(source.begin()), m_counted(source.begin()) {}
 
   inline bool eof() const {
     return m_iterator == m_source.end();
   }
 
   Token<CharT> tokenize() {
-    Token<CharT> token{{}, TOKEN_NONE, {m_source, m_iterator}};
+    StringViewT expression{};
+    TokenCategory category = TOKEN_EMPTY;
 
-    if (eof()) {
-      token.category = TOKEN_EOF;
-      return token;
+    // Empty tokens are skipped
+    while (category == TOKEN_EMPTY) category = scan(expression);
+
+    return {expression, category, location(expression.begin())};
+  }
+
+  // Tokens from the current position to the end of the source, empty ones skipped, followed by
+  // a single eof token
+  TokenBuffer<CharT> tokenize_all() {
+    check_range();
+
+    TokenBuffer<CharT> tokens{m_source};
+    tokens.reserve((m_source.end() - m_iterator) / 4);
+
+    while (scan(tokens, true) != TOKEN_EOF) {}
+
+    return tokens;
+  }
+
+  // Same tokens as tokenize_all, the source being split in chunks of at least the given size
+  // which are tokenized on their own threads. A chunk may start in the middle of a token, a
+  // string most notably, so each one is tokenized twice: from its first character and from past
+  // its first quote. Tokenizing only depends on where it starts, once the tokens of the previous
+  // chunks reach the start of a speculative token, all the tokens that follow it are the actual
+  // ones. Chunks are stitched in order, scanning sequentially until one of their speculations
+  // is reached, and errors are raised by that sequential scan exactly as tokenize_all raises them.
+  TokenBuffer<CharT> tokenize_parallel(size_t threads = std::thread::hardware_concurrency(),
+                                       size_t chunk = PARALLEL_CHUNK) {
+    check_range();
+
+    size_t begin = m_iterator - m_source.begin();
+    size_t chunks = std::min(threads, (m_source.size() - begin) / std::max<size_t>(chunk, 1));
+    if (chunks < 2) return tokenize_all();
+
+    std::vector<size_t> bounds(chunks + 1);
+    for (size_t i = 0; i <= chunks; i++) {
+      bounds[i] = begin + (m_source.size() - begin) * i / chunks;
     }
 
-    for (auto &[category, regex] : s_token_patterns) {
-      if (RegexMatch match = regex.match(m_iterator, m_source.end())) {
-        token.expression = {m_iterator, m_iterator += match.length};
-        token.category = category;
-        break;
+    std::vector<std::array<Speculation, 2>> speculations(chunks);
+    std::vector<std::vector<size_t>> newlines(chunks);
+    std::vector<std::exception_ptr> errors(chunks);
+
+    auto speculate_chunk = [&](size_t i) {
+      try {
+        for (size_t offset = bounds[i]; offset < bounds[i + 1]; offset++) {
+          if (m_source[offset] == CharT{'\n'}) newlines[i].push_back(offset);
+        }
+
+        speculations[i][0] = speculate(bounds[i], bounds[i + 1]);
+
+        // The chunk start is known to be outside of any token for the first chunk only
+        size_t quote = m_source.substr(0, bounds[i + 1]).find(CharT{'"'}, bounds[i]);
+        if (i > 0 && quote != StringViewT::npos) {
+          speculations[i][1] = speculate(quote + 1, bounds[i + 1]);
+        }
+      } catch (...) {
+        errors[i] = std::current_exception();
       }
+    };
+
+    {
+      std::vector<std::jthread> workers{};
+      workers.reserve(chunks - 1);
+
+      for (size_t i = 1; i < chunks; i++) workers.emplace_back(speculate_chunk, i);
+      speculate_chunk(0);
     }
 
-    if (token.category == TOKEN_NONE) {
-      throw ScannerException<CharT>("Unrecognized token", token);
+    for (const std::exception_ptr &error : errors) {
+      if (error) std::rethrow_exception(error);
     }
 
-    // Empty tokens are skipped
-    return token.category != TOKEN_EMPTY ? token : tokenize();
+    TokenBuffer<CharT> tokens{m_source};
+    tokens.reserve(speculations[0][0].tokens.size() * chunks);
+
+    for (const std::vector<size_t> &offsets : newlines) {
+      for (size_t offset : offsets) tokens.newline(offset);
+    }
+
+    for (size_t i = 0; i < chunks; i++) {
+      auto boundary = m_source.begin() + bounds[i + 1];
+      bool spliced = false;
+
+      while (m_iterator < boundary) {
+        size_t offset = m_iterator - m_source.begin();
+
+        for (size_t k = 0; !spliced && k < speculations[i].size(); k++) {
+          const Speculation &speculation = speculations[i][k];
+          size_t first = speculation.tokens.find(offset);
+
+          if (first < speculation.tokens.size() && speculation.tokens.offset(first) == offset) {
+            tokens.append(speculation.tokens, first);
+            m_iterator = m_source.begin() + speculation.end;
+            spliced = true;
+          }
+        }
+
+        if (m_iterator < boundary) scan(tokens, false);
+      }
+    }
+
+    scan(tokens, false);
+    return tokens;
   }
 
  private:
+  constexpr static size_t PARALLEL_CHUNK = 1 << 20;
+
+  // Tokens of a chunk scanned from a guessed start, up to the first token starting past the chunk
+  struct Speculation {
+    TokenBuffer<CharT> tokens{StringViewT{}};
+    size_t end = 0;
+  };
+
+  // Matches the longest token at the beginning of the range
+  template <typename Iterator>
+  static RegexMatch match(Iterator begin, Iterator end) {
+#ifdef SDATA_TOKEN_LEXER_GENERATED
+    return token_lexer_generated(begin, end);
+#else
+    return s_token_lexer.run(begin, end);
+#endif
+  }
+
+  // Stops at the first error instead of raising it, the speculation is then only used up to there
+  Speculation speculate(size_t offset, size_t boundary) const {
+    Speculation speculation{TokenBuffer<CharT>{m_source}, offset};
+
+    while (speculation.end < boundary) {
+      RegexMatch token = match(m_source.begin() + speculation.end, m_source.end());
+      if (!token) break;
+
+      TokenCategory category = s_token_patterns[token.pattern].first;
+
+      if (category != TOKEN_EMPTY) {
+        if (token.length > TokenBuffer<CharT>::LENGTH_MAX) break;
+
+        speculation.tokens.push(speculation.end, token.length, category);
+      }
+
+      speculation.end += token.length;
+    }
+
+    return speculation;
+  }
+
+  // Offsets within the source fit in token buffers
+  void check_range() {
+    if (m_source.size() > TokenBuffer<CharT>::OFFSET_MAX) {
+      throw ScannerException<CharT>("Source out of the token buffer range",
+                                    {{}, TOKEN_NONE, location(m_iterator)});
+    }
+  }
+
+  // Scans the next token into the buffer, and records its newlines when asked to
+  TokenCategory scan(TokenBuffer<CharT> &tokens, bool newlines) {
+    StringViewT expression{};
+    TokenCategory category = scan(expression);
+    size_t offset = expression.begin() - m_source.begin();
+
+    for (size_t i = 0; newlines && i < expression.size(); i++) {
+      if (expression[i] == CharT{'\n'}) tokens.newline(offset + i);
+    }
+
+    if (category == TOKEN_EMPTY) return category;
+
+    if (expression.size() > TokenBuffer<CharT>::LENGTH_MAX) {
+      throw ScannerException<CharT>(
+          "Token out of the token buffer range",
+          {expression, category, location(expression.begin())});
+    }
+
+    tokens.push(offset, expression.size(), category);
+    return category;
+  }
+
+  // Moves past the next token, empty ones included, and returns its category
+  TokenCategory scan(StringViewT &expression) {
+    if (eof()) {
+      expression = {m_iterator, m_iterator};
+      return TOKEN_EOF;
+    }
+
+    RegexMatch match = Scanner::match(m_iterator, m_source.end());
+
+    if (!match) {
+      throw ScannerException<CharT>("Unrecognized token", {{}, TOKEN_NONE, location(m_iterator)});
+    }
+
+    expression = {m_iterator, m_iterator += match.length};
+    return s_token_patterns[match.pattern].first;
+  }
+
+  // Lines are counted from the previous token on, tokenizing a source stays linear
+  SourceLocation<CharT> location(typename StringViewT::iterator iterator) {
+    m_line += std::count(m_counted, iterator, CharT{'\n'});
+    m_counted = iterator;
+    return {m_source, iterator, m_line};
+  }
+
   StringViewT m_source;
   typename StringViewT::iterator m_iterator;
+  typename StringViewT::iterator m_counted;  // End of the counted lines
+  size_t m_line = 0;
+};
+
+// Scanner pulling its source in chunks from a stream or a file descriptor. A token reaching the
+// end of the buffer while it could still grow is matched again once the next chunk is read, the
+// buffer only holds the current token and the unscanned input: memory stays within a chunk and
+// the largest token. Token expressions and locations point into the buffer, they are valid until
+// the next call to tokenize.
+template <typename CharT>
+class StreamScanner {
+  using StringViewT = std::basic_string_view<CharT>;
+  using Read = std::function<size_t(CharT *data, size_t size)>;
+
+ public:
+  constexpr static size_t CHUNK = 64 * 1024;
+
+  explicit StreamScanner(std::basic_istream<CharT> &stream, size_t chunk = CHUNK)
+      : m_read([&stream](CharT *data, size_t size) -> size_t {
+          stream.read(data, size);
+          return stream.gcount();
+        }),
+        m_chunk(std::max<size_t>(chunk, 1)) {}
+
+#ifdef SDATA_SCANNER_DESCRIPTORS
+  // Reads bytes from the descriptor, which stays open
+  explicit StreamScanner(int descriptor, size_t chunk = CHUNK)
+    requires(sizeof(CharT) == 1)
+      : m_read([descriptor](CharT *data, size_t size) -> size_t {
+          ssize_t count = 0;
+          do count = ::read(descriptor, data, size);
+          while (count < 0 && errno == EINTR);
+
+          if (count < 0) {
+            throw std::runtime_error{fmt<char>("Can't read source from descriptor %", descriptor)};
+          }
+
+          return count;
+        }),
+        m_chunk(std::max<size_t>(chunk, 1)) {}
+#endif
+
+  Token<CharT> tokenize() {
+    StringViewT expression{};
+    TokenCategory category = TOKEN_EMPTY;
+
+    // Empty tokens are skipped
+    while (category == TOKEN_EMPTY) category = scan(expression);
+
+    return {expression, category, {m_buffer, expression.begin(), m_token_line}};
+  }
+
+ private:
+  using Iterator = typename std::basic_string<CharT>::const_iterator;
+
+  // Moves past the next token, empty ones included, and returns its category
+  TokenCategory scan(StringViewT &expression) {
+    for (;;) {
+      Iterator begin = m_buffer.cbegin() + m_position, end = m_buffer.cend();
+      bool open = false;
+      RegexMatch match = run(begin, end, open);
+
+      if (open && fill()) continue;
+
+      m_token_line = m_line;
+
+      if (begin == end) {
+        expression = {m_buffer.data() + m_position, 0};
+        return TOKEN_EOF;
+      }
+
+      if (!match) {
+        StringViewT buffer{m_buffer};
+        throw ScannerException<CharT>(
+            "Unrecognized token", {{}, TOKEN_NONE, {buffer, buffer.begin() + m_position, m_line}});
+      }
+
+      expression = {m_buffer.data() + m_position, match.length};
+      m_position += match.length;
+      m_line += std::count(expression.begin(), expression.end(), CharT{'\n'});
+
+      return s_token_patterns[match.pattern].first;
+    }
+  }
+
+  // Longest token at the front of the range, open is set when more input could extend it
+  static RegexMatch run(Iterator begin, Iterator end, bool &open) {
+    RegexDfaView::State state = s_token_lexer.start();
+    RegexMatch match{s_token_lexer.accepts(state), 0, s_token_lexer.accepted(state)};
+    Iterator input = begin;
+
+    while (input != end && state != RegexDfaView::DEAD) {
+      state = s_token_lexer.next(state, RegexDfaView::column(*input++));
+
+      if (s_token_lexer.accepts(state)) {
+        match = {true, (size_t)(input - begin), s_token_lexer.accepted(state)};
+      }
+    }
+
+    open = input == end && state != RegexDfaView::DEAD;
+    return match;
+  }
+
+  // Drops the scanned input and reads the next chunk, returns false at the end of the source.
+  // Chunks grow with the buffer so that a large token is not matched again once per chunk.
+  bool fill() {
+    if (m_ended) return false;
+
+    m_buffer.erase(0, m_position);
+    m_position = 0;
+
+    size_t size = m_buffer.size(), chunk = std::max(m_chunk, size);
+    m_buffer.resize(size + chunk);
+    m_buffer.resize(size + m_read(m_buffer.data() + size, chunk));
+
+    m_ended = m_buffer.size() == size;
+    return !m_ended;
+  }
+
+  Read m_read;
+  size_t m_chunk;
+  std::basic_string<CharT> m_buffer;
+  size_t m_position = 0;  // First unscanned character of the buffer
+  size_t m_line = 0, m_token_line = 0;
+  bool m_ended = false;
 };
 
 }  // namespace sdata
@@ -2,5 +2,6 @@
 #define SDATA_HPP
 
 #include "io.hpp"
+#include "reader.hpp"
 
 #endif
@@ -1,7 +1,9 @@
 #ifndef SDATA_TOKEN_HPP
 #define SDATA_TOKEN_HPP
 
-#include <unordered_map>
+#include <algorithm>
+#include <array>
+#include <vector>
 #include "misc/source_location.hpp"
 #include "regex/regex.hpp"
 #include "misc/string.hpp"
@@ -20,15 +22,19 @@ enum TokenCategory : unsigned int {
   TOKEN_BOOL = 1 << 5,
   TOKEN_STRING = 1 << 6,
   TOKEN_CHAR = 1 << 7,
-  TOKEN_DATA = TOKEN_FLOAT | TOKEN_INT | TOKEN_BOOL | TOKEN_STRING | TOKEN_CHAR,
+  TOKEN_DOUBLE = 1 << 8,
+  TOKEN_INT64 = 1 << 9,
+  TOKEN_UINT64 = 1 << 10,
+  TOKEN_DATA = TOKEN_FLOAT | TOKEN_INT | TOKEN_BOOL | TOKEN_STRING | TOKEN_CHAR | TOKEN_DOUBLE |
+               TOKEN_INT64 | TOKEN_UINT64,
 
-  TOKEN_BEG_SEQ = 1 << 8,
-  TOKEN_END_SEQ = 1 << 9,
+  TOKEN_BEG_SEQ = 1 << 11,
+  TOKEN_END_SEQ = 1 << 12,
 
-  TOKEN_EMPTY = 1 << 10,
-  TOKEN_EOF = 1 << 11,
+  TOKEN_EMPTY = 1 << 13,
+  TOKEN_EOF = 1 << 14,
 
-  TOKEN_CATEGORY_MAX = 1 << 12,
+  TOKEN_CATEGORY_MAX = 1 << 15,
 };
 
 constexpr static std::string_view token_category_name(TokenCategory category) {
@@ -41,6 +47,9 @@ constexpr static std::string_view token_category_name(TokenCategory category) {
     case TOKEN_BOOL: return "bool";
     case TOKEN_STRING: return "string";
     case TOKEN_CHAR: return "character";
+    case TOKEN_DOUBLE: return "double";
+    case TOKEN_INT64: return "int64";
+    case TOKEN_UINT64: return "uint64";
     case TOKEN_BEG_SEQ: return "sequence-begin";
     case TOKEN_END_SEQ: return "sequence-ending";
     case TOKEN_EMPTY: return "empty";
@@ -52,19 +61,70 @@ inline std::ostream &operator<<(std::ostream &os, TokenCategory category) {
   return os << token_category_name(category);
 }
 
-inline static const std::unordered_map<TokenCategory, Regex> s_token_patterns = {
-    {TOKEN_SEPARATOR, {" ',' "}},
-    {TOKEN_END_SEQ, {" '}' "}},
-    {TOKEN_BEG_SEQ, {" '{' "}},
-    {TOKEN_ASSIGN, {" ':' "}},
-    {TOKEN_ID, {"{a|'_'} {a|n|'_'}*"}},
-    {TOKEN_INT, {"{'-'|'+'}? n+"}},
-    {TOKEN_FLOAT, {"{'-'|'+'}? n+ '.' n+ 'f'?"}},
-    {TOKEN_BOOL, {"'true'|'false'"}},
-    {TOKEN_CHAR, {"q^q"}},
-    {TOKEN_STRING, {"Q~Q"}},
-    {TOKEN_EMPTY, {"_+"}},
-};
+// Token patterns by priority, the scanner picks the longest match and ties go to the first pattern
+// Numbers are typed by their suffix, the one of floats being optional. It is written as an
+// alternative with the suffixed branch first: the lexer never takes an optional operand when the
+// match can end before it.
+inline constexpr std::array<std::pair<TokenCategory, StaticRegex>, 14> s_token_patterns = {{
+    {TOKEN_SEPARATOR, static_regex<" ',' ">},
+    {TOKEN_END_SEQ, static_regex<" '}' ">},
+    {TOKEN_BEG_SEQ, static_regex<" '{' ">},
+    {TOKEN_ASSIGN, static_regex<" ':' ">},
+    {TOKEN_BOOL, static_regex<"'true'|'false'">},
+    {TOKEN_ID, static_regex<"{a|'_'} {a|n|'_'}*">},
+    {TOKEN_INT, static_regex<"{'-'|'+'}? n+">},
+    {TOKEN_INT64, static_regex<"{'-'|'+'}? n+ 'l'">},
+    {TOKEN_UINT64, static_regex<"'+'? n+ 'u'">},
+    {TOKEN_FLOAT, static_regex<"{'-'|'+'}? n+ '.' {{n+ 'f'}|n+}">},
+    {TOKEN_DOUBLE, static_regex<"{'-'|'+'}? n+ '.' n+ 'd'">},
+    {TOKEN_CHAR, static_regex<"q^q">},
+    {TOKEN_STRING, static_regex<"Q~Q">},
+    {TOKEN_EMPTY, static_regex<"_+">},
+}};
+
+constexpr RegexDfa compile_token_lexer() {
+  std::vector<RegexAutomata> automatas{};
+  std::vector<const RegexAutomata *> pointers{};
+
+  for (const auto &[category, regex] : s_token_patterns) {
+    automatas.push_back(RegexParser{regex.pattern()}.parse());
+  }
+  for (const RegexAutomata &automata : automatas) {
+    pointers.push_back(&automata);
+  }
+
+  return RegexDfa{pointers};
+}
+
+// Every token pattern compiled into a single automata, each token is scanned in one pass
+inline constexpr auto s_token_lexer_dfa = make_static_dfa<compile_token_lexer>();
+inline constexpr RegexDfaView s_token_lexer = s_token_lexer_dfa.view();
+
+// Native form of s_token_lexer, compiled on first use
+inline const RegexJit &token_lexer_jit() {
+  static const RegexJit jit{s_token_lexer};
+  return jit;
+}
+
+// Identifies the token grammar, generated scanners check it against the grammar they come from
+constexpr uint64_t token_patterns_hash() {
+  uint64_t hash = 0xcbf29ce484222325;
+
+  for (const auto &[category, regex] : s_token_patterns) {
+    hash = (hash ^ category) * 0x100000001b3;
+    for (char c : regex.pattern()) hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3;
+  }
+
+  return hash;
+}
+
+constexpr StaticRegex token_pattern(TokenCategory category) {
+  auto pattern = std::ranges::find_if(s_token_patterns, [category](const auto &pattern) {
+    return pattern.first == category;
+  });
+  SDATA_ASSERT(pattern != s_token_patterns.end(), "Token category has no pattern");
+  return pattern->second;
+}
 
 template <typename CharT>
 struct Token {
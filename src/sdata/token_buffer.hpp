@@ -0,0 +1,113 @@
+#ifndef SDATA_TOKEN_BUFFER_HPP
+#define SDATA_TOKEN_BUFFER_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "misc/assert.hpp"
+#include "misc/source_location.hpp"
+#include "token.hpp"
+
+namespace sdata {
+
+// Tokens of a source stored as structure of arrays, 8 bytes per token: a 32 bits offset and a
+// 32 bits word packing the length over 24 bits with the category bit index over 8 bits. Lines
+// are resolved through the offsets of the newlines of the source, only when asked for. Sources
+// are thus limited to OFFSET_MAX code units and tokens to LENGTH_MAX, which scanners check.
+template <typename CharT>
+class TokenBuffer {
+  using StringViewT = std::basic_string_view<CharT>;
+
+ public:
+  constexpr static size_t OFFSET_MAX = UINT32_MAX;
+  constexpr static size_t LENGTH_MAX = (1 << 24) - 1;
+
+  explicit TokenBuffer(StringViewT source) : m_source(source) {
+    SDATA_ASSERT(source.size() <= OFFSET_MAX, "Source out of the buffer range");
+  }
+
+  inline void push(size_t offset, size_t length, TokenCategory category) {
+    SDATA_ASSERT(offset <= OFFSET_MAX && length <= LENGTH_MAX, "Token out of the buffer range");
+    SDATA_ASSERT(category != TOKEN_NONE, "Buffered tokens have a category");
+
+    m_offsets.push_back(offset);
+    m_words.push_back(length << 8 | std::countr_zero<unsigned int>(category));
+  }
+
+  // Newlines are recorded in order, as the source is tokenized
+  inline void newline(size_t offset) {
+    m_newlines.push_back(offset);
+  }
+
+  // Appends the tokens of another buffer over the same source, from the given index on
+  inline void append(const TokenBuffer &tokens, size_t first) {
+    SDATA_ASSERT(tokens.m_source.data() == m_source.data(), "Buffers tokenize the same source");
+
+    m_offsets.insert(m_offsets.end(), tokens.m_offsets.begin() + first, tokens.m_offsets.end());
+    m_words.insert(m_words.end(), tokens.m_words.begin() + first, tokens.m_words.end());
+  }
+
+  inline void reserve(size_t tokens) {
+    m_offsets.reserve(tokens);
+    m_words.reserve(tokens);
+  }
+
+  inline size_t size() const {
+    return m_offsets.size();
+  }
+
+  inline bool empty() const {
+    return m_offsets.empty();
+  }
+
+  inline size_t offset(size_t index) const {
+    return m_offsets[index];
+  }
+
+  inline size_t length(size_t index) const {
+    return m_words[index] >> 8;
+  }
+
+  inline TokenCategory category(size_t index) const {
+    return static_cast<TokenCategory>(1u << (m_words[index] & 0xff));
+  }
+
+  inline StringViewT expression(size_t index) const {
+    return m_source.substr(offset(index), length(index));
+  }
+
+  // Index of the first token starting at or after the offset, size() when there is none
+  inline size_t find(size_t offset) const {
+    return std::lower_bound(m_offsets.begin(), m_offsets.end(), offset) - m_offsets.begin();
+  }
+
+  // Newlines before the token, in logarithmic time
+  inline size_t line(size_t index) const {
+    return std::upper_bound(m_newlines.begin(), m_newlines.end(), m_offsets[index]) -
+           m_newlines.begin();
+  }
+
+  inline Token<CharT> operator[](size_t index) const {
+    return {
+        expression(index),
+        category(index),
+        {m_source, m_source.begin() + offset(index), line(index)},
+    };
+  }
+
+  inline StringViewT source() const {
+    return m_source;
+  }
+
+ private:
+  StringViewT m_source;
+  std::vector<uint32_t> m_offsets;
+  std::vector<uint32_t> m_words;
+  std::vector<uint32_t> m_newlines;
+};
+
+}  // namespace sdata
+
+#endif
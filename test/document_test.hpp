@@ -0,0 +1,126 @@
+#ifndef SDATA_DOCUMENT_TEST_HPP
+#define SDATA_DOCUMENT_TEST_HPP
+
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <sdata.hpp>
+
+using namespace sdata;
+
+TEST_CASE("Arena") {
+  Arena arena{64};
+
+  auto *value = arena.create<uint64_t>(42);
+  auto *bytes = arena.allocate<char>(3);
+  auto *aligned = arena.create<double>(1.5);
+
+  CHECK(*value == 42);
+  CHECK(reinterpret_cast<uintptr_t>(aligned) % alignof(double) == 0);
+  CHECK(bytes != nullptr);
+  CHECK(arena.blocks() == 1);
+
+  std::string_view copied = arena.copy(std::string_view{"copied"});
+  CHECK(copied == "copied");
+
+  // Allocations larger than the next block get a block of their own
+  auto large = arena.allocate<std::byte>(1000);
+  CHECK(large != nullptr);
+  CHECK(arena.blocks() == 2);
+
+  Arena moved{std::move(arena)};
+  CHECK(*value == 42);
+  CHECK(moved.blocks() == 2);
+  CHECK(arena.blocks() == 0);
+}
+
+TEST_CASE("Document<char>") {
+  Document<char> document = document_from_file<char>("examples/game.sd");
+  REQUIRE(document.root() != nullptr);
+
+  CHECK(*document.root()->to_node() == *from_file<char>("examples/game.sd"));
+  CHECK(document.root()->id() == "tetris");
+  CHECK(document.at("window/width")->as<int>() == 1920);
+  CHECK(document.at("window/title")->as<std::string_view>() == "Tetris game");
+  CHECK(document.at("controls/pause")->as<char>() == 'p');
+  CHECK(document.at("window/fullscreen")->as<bool>() == false);
+  CHECK(document.at("window/missing") == nullptr);
+  CHECK(document.at("window/width/more") == nullptr);
+  CHECK(document.root()->members().size() == 2);
+
+  CHECK_THROWS_AS(document.at("window")->as<int>(), DocumentException);
+
+  // Identifiers and strings are copied, the document outlives the source
+  Document<char> copied{};
+  {
+    std::string source = read_source_file<char>("examples/game.sd");
+    copied = document_from_source<char>(source);
+    source.assign(source.size(), ' ');
+  }
+  CHECK(*copied.root()->to_node() == *document.root()->to_node());
+
+  CHECK(document_from_source<char>("").root() == nullptr);
+  CHECK_THROWS_AS(document_from_source<char>("root: { a: 1 }"), ParserException<char>);
+}
+
+TEST_CASE("Document<char> arena") {
+  // 100k nodes in a few blocks
+  std::string source = "root {\n";
+  for (size_t i = 0; i < 10000; i++) {
+    source += "  group_" + std::to_string(i) + " {";
+    for (size_t j = 0; j < 9; j++) source += " v" + std::to_string(j) + ": \"value\",";
+    source.back() = '}';
+    source += ",\n";
+  }
+  source += "  last: 0\n}";
+
+  Document<char> document = document_from_source<char>(source);
+
+  CHECK(document.root()->members().size() == 10001);
+  CHECK(document.at("group_9999/v8")->as<std::string_view>() == "value");
+  CHECK(document.arena().blocks() <= 8);
+  CHECK(*document.root()->to_node() == *from_source<char>(source));
+}
+
+TEST_CASE("Document<char> views") {
+  std::string source = read_source_file<char>("examples/game.sd");
+  auto inside = [&source](auto view) {
+    return view.data() >= source.data() &&
+           view.data() + view.size() <= source.data() + source.size();
+  };
+
+  Document<char> copied = document_from_source<char>(source);
+  Document<char> viewed = document_from_source<char>(source, DOCUMENT_VIEW);
+
+  CHECK(*viewed.root()->to_node() == *copied.root()->to_node());
+  CHECK(inside(viewed.root()->id()));
+  CHECK(inside(viewed.at("window/title")->as<std::string_view>()));
+  CHECK(!inside(copied.at("window/title")->as<std::string_view>()));
+  CHECK(viewed.arena().used() < copied.arena().used());
+
+  // Shared sources are pinned by the document
+  Document<char> pinned{};
+  {
+    auto shared = std::make_shared<const std::string>(source);
+    pinned = document_from_source<char>(shared);
+  }
+  CHECK(pinned.at("window/title")->as<std::string_view>() == "Tetris game");
+  CHECK(*pinned.root()->to_node() == *copied.root()->to_node());
+
+  Document<char> file = document_from_file<char>("examples/game.sd", DOCUMENT_VIEW);
+  CHECK(*file.root()->to_node() == *copied.root()->to_node());
+
+  // Streamed tokens do not outlive the parser, they are copied
+  std::istringstream stream{source};
+  Document<char> streamed = Parser<char>{stream}.parse_document(DOCUMENT_VIEW);
+  CHECK(streamed.at("window/title")->as<std::string_view>() == "Tetris game");
+}
+
+TEST_CASE("Document<char16_t>") {
+  Document<char16_t> document = document_from_file<char16_t>("examples/dialog.sd");
+
+  CHECK(*document.root()->to_node() == *from_file<char16_t>("examples/dialog.sd"));
+  CHECK(document.at(u"fr_FR/game_over_dialog/play_again_accept")->as<std::u16string_view>() ==
+        u"Oui");
+}
+
+#endif
@@ -15,6 +15,30 @@ TEST_CASE("Emitter<char>") {
   CHECK(*from_source<char>(emitted) == *root);
 }
 
+TEST_CASE("Emitter<char> numbers") {
+  auto numbers = std::make_shared<Node>("numbers", Sequence{});
+  numbers->emplace("int", -7);
+  numbers->emplace("float", 0.1f);
+  numbers->emplace("double", 0.1);
+  numbers->emplace("round", 100.0);
+  numbers->emplace("large", 1e300);
+  numbers->emplace("small", -5e-324);
+  numbers->emplace("int64", INT64_MIN);
+  numbers->emplace("uint64", UINT64_MAX);
+
+  auto emitted = to_source<char>(numbers);
+
+  // Shortest forms reading back to the same values
+  CHECK(emitted.find("float: 0.1,") != emitted.npos);
+  CHECK(emitted.find("double: 0.1d,") != emitted.npos);
+  CHECK(emitted.find("round: 100.0d,") != emitted.npos);
+  CHECK(emitted.find("uint64: 18446744073709551615u") != emitted.npos);
+  CHECK(*from_source<char>(emitted) == *numbers);
+
+  numbers->emplace("nan", std::numeric_limits<double>::quiet_NaN());
+  CHECK_THROWS_AS(to_source<char>(numbers), EmitterException);
+}
+
 TEST_CASE("Emitter<char16_t>") {
   auto source = read_source_file<char16_t>("examples/dialog.sd");
   auto root = Parser<char16_t>{source}.parse();
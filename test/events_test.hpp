@@ -0,0 +1,79 @@
+#ifndef SDATA_EVENTS_TEST_HPP
+#define SDATA_EVENTS_TEST_HPP
+
+#include <catch2/catch.hpp>
+#include <sdata.hpp>
+#include <sstream>
+
+using namespace sdata;
+
+// Writes the events back as a source, one part per line
+template <typename CharT>
+struct EventRecorder {
+  void key(std::basic_string_view<CharT> id) {
+    events += "key " + std::string(id.begin(), id.end()) + "\n";
+  }
+
+  void begin_sequence() {
+    events += "{\n";
+  }
+
+  void end_sequence() {
+    events += "}\n";
+  }
+
+  void value(std::basic_string_view<CharT> string) {
+    events += "string " + std::string(string.begin(), string.end()) + "\n";
+  }
+
+  void value(CharT character) {
+    events += "char " + std::string(1, static_cast<char>(character)) + "\n";
+  }
+
+  template <typename T>
+  void value(T value) {
+    std::ostringstream stream;
+    stream << Node::type_name(Node{"", value}.type()) << ' ' << std::boolalpha << value << '\n';
+    events += stream.str();
+  }
+
+  std::string events{};
+};
+
+TEST_CASE("Parser<char> events") {
+  EventRecorder<char> recorder{};
+  parse_events<char>(read_source_file<char>("examples/game.sd"), recorder);
+
+  CHECK(recorder.events ==
+        "key tetris\n{\n"
+        "key window\n{\n"
+        "key width\nint 1920\nkey height\nint 1080\n"
+        "key title\nstring Tetris game\nkey fullscreen\nbool false\n}\n"
+        "key controls\n{\n"
+        "key left\nchar a\nkey right\nchar d\nkey confirm\nchar e\nkey pause\nchar p\n}\n}\n");
+
+  // Anonymous sequences have no key, sized numbers keep their type
+  EventRecorder<char> numbers{};
+  parse_events<char>("{ a: 1.5d, b: 2l, c: 3u, d: 4.5 }", numbers);
+  CHECK(numbers.events ==
+        "{\nkey a\ndouble 1.5\nkey b\nint64 2\nkey c\nuint64 3\nkey d\nfloat 4.5\n}\n");
+
+  // Streamed keys and strings are valid during their call
+  std::istringstream stream{read_source_file<char>("examples/game.sd")};
+  EventRecorder<char> streamed{};
+  parse_events<char>(stream, streamed);
+  CHECK(streamed.events == recorder.events);
+
+  EventRecorder<char> invalid{};
+  CHECK_THROWS_AS(parse_events<char>("root { a: 1 b: 2 }", invalid), ParserException<char>);
+  CHECK(invalid.events == "key root\n{\nkey a\nint 1\n");
+}
+
+TEST_CASE("Parser<char16_t> events") {
+  EventRecorder<char16_t> recorder{};
+  parse_events<char16_t>(u"dialog { title: \"Game over\", key: 'k' }", recorder);
+
+  CHECK(recorder.events == "key dialog\n{\nkey title\nstring Game over\nkey key\nchar k\n}\n");
+}
+
+#endif
@@ -4,6 +4,9 @@
 #include "regex_test.hpp"
 #include "scanner_test.hpp"
 #include "parser_test.hpp"
+#include "document_test.hpp"
+#include "events_test.hpp"
+#include "reader_test.hpp"
 #include "emitter_test.hpp"
 
 int main(int argc, char **argv) {
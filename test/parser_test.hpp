@@ -23,6 +23,36 @@ TEST_CASE("Parser<char>") {
   }
 
   REQUIRE(*game == *from_file<char>("examples/game.sd"));
+
+  // Paths are resolved member by member
+  CHECK(game->at("window/width")->as<int>() == 1920);
+  CHECK(game->at("controls/pause")->as<char>() == 'p');
+  CHECK(game->at("window/missing") == nullptr);
+  CHECK(game->at("missing/width") == nullptr);
+  CHECK(game->at("") == game);
+
+  std::istringstream stream{read_source_file<char>("examples/game.sd")};
+  REQUIRE(*game == *from_stream<char>(stream));
+}
+
+TEST_CASE("Parser<char> numbers") {
+  auto numbers = from_source<char>(
+      "numbers { int: -2147483648, float: 1.5f, plain: 0.25, double: 0.1d, int64: "
+      "-9223372036854775808l, uint64: +18446744073709551615u }");
+
+  CHECK(numbers->at("int")->as<int>() == INT32_MIN);
+  CHECK(numbers->at("float")->as<float>() == 1.5f);
+  CHECK(numbers->at("plain")->as<float>() == 0.25f);
+  CHECK(numbers->at("double")->as<double>() == 0.1);
+  CHECK(numbers->at("int64")->as<int64_t>() == INT64_MIN);
+  CHECK(numbers->at("uint64")->as<uint64_t>() == UINT64_MAX);
+
+  CHECK_THROWS_AS(from_source<char>("int: 2147483648"), ParserException<char>);
+  CHECK_THROWS_AS(from_source<char>("uint64: 18446744073709551616u"), ParserException<char>);
+
+  auto wide = from_source<char16_t>(u"numbers { a: 7, b: -0.5d, c: 42u }");
+  CHECK(wide->at("b")->as<double>() == -0.5);
+  CHECK(wide->at("c")->as<uint64_t>() == 42);
 }
 
 TEST_CASE("Parser<char16_t>") {
@@ -0,0 +1,157 @@
+#ifndef SDATA_READER_TEST_HPP
+#define SDATA_READER_TEST_HPP
+
+#include <catch2/catch.hpp>
+#include <sdata.hpp>
+
+using namespace sdata;
+
+// Value at the slash separated path, skipping every other subtree
+template <typename T>
+T read_path(Reader<char> &reader, std::string_view path) {
+  while (reader.next()) {
+    std::string_view id = path.substr(0, path.find('/'));
+    if (reader.key() != id) continue;
+
+    if (id.size() == path.size()) return reader.value<T>();
+
+    path.remove_prefix(id.size() + 1);
+    reader.enter();
+  }
+
+  FAIL("Path not found");
+  return {};
+}
+
+TEST_CASE("Reader<char>") {
+  std::string source = read_source_file<char>("examples/game.sd");
+
+  SECTION("Paths") {
+    Reader<char> reader{source};
+    CHECK(read_path<int>(reader, "tetris/window/width") == 1920);
+
+    // Following nodes of the same sequence are still read
+    CHECK(read_path<std::string_view>(reader, "title") == "Tetris game");
+    CHECK(read_path<bool>(reader, "fullscreen") == false);
+
+    // Then the parent sequence once the current one ends
+    CHECK_FALSE(reader.next());
+    CHECK(reader.depth() == 1);
+    CHECK(read_path<char>(reader, "controls/pause") == 'p');
+  }
+
+  SECTION("Walk") {
+    Reader<char> reader{source};
+    std::string walk{};
+
+    // Every sequence entered, every value skipped but the strings
+    for (;;) {
+      size_t depth = reader.depth();
+
+      if (!reader.next()) {
+        if (depth == 0) break;
+        walk += "} ";
+        continue;
+      }
+
+      walk += std::string{reader.key()} + (reader.is_sequence() ? " { " : " ");
+      if (reader.is_sequence()) reader.enter();
+      if (reader.category() == TOKEN_STRING) walk += reader.value<std::string>() + " ";
+    }
+
+    CHECK(walk ==
+          "tetris { window { width height title Tetris game fullscreen } "
+          "controls { left right confirm pause } } ");
+  }
+
+  SECTION("Skips") {
+    Reader<char> reader{source};
+    REQUIRE(reader.next());
+    reader.enter();
+
+    // Sequences not entered are skipped by next
+    REQUIRE(reader.next());
+    CHECK(reader.key() == "window");
+    REQUIRE(reader.next());
+    CHECK(reader.key() == "controls");
+
+    reader.skip();
+    CHECK_FALSE(reader.is_sequence());
+    CHECK_FALSE(reader.next());
+    CHECK_FALSE(reader.next());
+    CHECK(reader.depth() == 0);
+  }
+
+  SECTION("Leave") {
+    Reader<char> reader{source};
+    CHECK_THROWS_AS(reader.leave(), ReaderException<char>);
+
+    CHECK(read_path<int>(reader, "tetris/window/width") == 1920);
+    reader.leave();
+    CHECK(reader.depth() == 1);
+    REQUIRE(reader.next());
+    CHECK(reader.key() == "controls");
+
+    // Right after entering, then from the parent which ends the root
+    reader.enter();
+    reader.leave();
+    CHECK_FALSE(reader.next());
+    CHECK(reader.depth() == 0);
+
+    // Remaining members are skipped, nested sequences included
+    Reader<char> nested{"root { a { b: 1, c { d { } }, e: 2 }, f: 3 }"};
+    CHECK(read_path<int>(nested, "root/a/b") == 1);
+    nested.leave();
+    CHECK(read_path<int>(nested, "f") == 3);
+
+    Reader<char> unterminated{"root { a { b: 1 }"};
+    unterminated.next();
+    unterminated.enter();
+    CHECK_THROWS_AS(unterminated.leave(), ParserException<char>);
+  }
+
+  SECTION("Errors") {
+    Reader<char> reader{source};
+    REQUIRE(reader.next());
+    CHECK_THROWS_AS(reader.value<int>(), ReaderException<char>);
+
+    reader.enter();
+    reader.next();
+    reader.enter();
+    reader.next();
+    CHECK_THROWS_AS(reader.value<float>(), ReaderException<char>);
+    CHECK_THROWS_AS(reader.enter(), ReaderException<char>);
+
+    // Skipped sequences are only checked for their braces
+    Reader<char> skipped{"root { a { b: @ }, c: 1 }"};
+    skipped.next();
+    skipped.enter();
+    skipped.next();
+    CHECK_THROWS_AS(skipped.next(), ScannerException<char>);
+
+    Reader<char> unterminated{"root { a { b: 1 }"};
+    unterminated.next();
+    CHECK_THROWS_AS(unterminated.next(), ParserException<char>);
+
+    Reader<char> invalid{"root { a: 1 b: 2 }"};
+    invalid.next();
+    invalid.enter();
+    invalid.next();
+    CHECK_THROWS_AS(invalid.next(), ParserException<char>);
+
+    CHECK_FALSE(Reader<char>{""}.next());
+  }
+
+  SECTION("Numbers") {
+    Reader<char> reader{"numbers { a: -2l, b: 18446744073709551615u, c: 0.1d, d: 1.5f }"};
+    reader.next();
+    reader.enter();
+
+    CHECK(read_path<int64_t>(reader, "a") == -2);
+    CHECK(read_path<uint64_t>(reader, "b") == UINT64_MAX);
+    CHECK(read_path<double>(reader, "c") == 0.1);
+    CHECK(read_path<float>(reader, "d") == 1.5f);
+  }
+}
+
+#endif
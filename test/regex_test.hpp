@@ -2,10 +2,17 @@
 #define SDATA_REGEX_TEST_HPP
 
 #include <catch2/catch.hpp>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <thread>
 #include <sdata/misc/fmt.hpp>
 #include <sdata/regex/regex.hpp>
+#include <sdata/token.hpp>
 
 using namespace sdata;
 using namespace sdata::regex_literals;
@@ -32,9 +39,9 @@ inline std::string quoted(std::string_view expression) {
 }
 
 TEST_CASE("Regex: Unknown tokens") {
-  CHECK_THROWS_AS("N"_re, RegexParserException);
-  CHECK_THROWS_AS(")"_re, RegexParserException);
-  CHECK_THROWS_AS("ù"_re, RegexParserException);
+  CHECK_THROWS_AS(Regex{"N"}, RegexParserException);
+  CHECK_THROWS_AS(Regex{")"}, RegexParserException);
+  CHECK_THROWS_AS(Regex{"ù"}, RegexParserException);
 }
 
 TEST_CASE("Regex: Literals") {
@@ -47,9 +54,9 @@ TEST_CASE("Regex: Literals") {
   }
 
   SECTION("Invalid") {
-    CHECK_THROWS_AS("'hello"_re, RegexParserException);
-    CHECK_THROWS_AS("hello'"_re, RegexParserException);
-    CHECK_THROWS_AS("hello"_re, RegexParserException);
+    CHECK_THROWS_AS(Regex{"'hello"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"hello'"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"hello"}, RegexParserException);
   }
 
   SECTION("False") {
@@ -80,6 +87,32 @@ TEST_CASE("Regex: Character classes") {
   }
 }
 
+TEST_CASE("Regex: Character class nodes") {
+  SECTION("Size") {
+    CHECK(Regex{"a"}.automata().size() == 1);
+    CHECK(Regex{"{a|'_'} {a|n|'_'}*"}.automata().size() < 16);
+  }
+
+  SECTION("Wide code units") {
+    RegexAutomata automata{};
+    const RegexRange ranges[] = {{'a', 'z'}, {0xe0, 0xff}};
+    const RegexClass &members = automata.character_class(automata.insert_class(ranges));
+
+    CHECK(automata.contains(members, 'k'));
+    CHECK(automata.contains(members, u'\u00e9'));
+    CHECK_FALSE(automata.contains(members, 'K'));
+    CHECK_FALSE(automata.contains(members, u'\u03bb'));
+    CHECK_FALSE(automata.contains(members, U'\U0001f600'));
+
+    // Every engine rejects code units wider than a byte the same way
+    Regex regex{"a+"};
+    std::u16string expression = u"ab\u03bb";
+    CHECK(regex.match(expression.begin(), expression.end()).length == 2);
+    CHECK(regex.dfa().run(expression.begin(), expression.end()).length == 2);
+    CHECK(RegexNfa{regex.automata()}.run(expression.begin(), expression.end()).length == 2);
+  }
+}
+
 TEST_CASE("Regex: Sequences") {
   SECTION("Basic") {
     CHECK("{'abc'}"_re.match("abc"));
@@ -88,11 +121,11 @@ TEST_CASE("Regex: Sequences") {
   }
 
   SECTION("Invalid") {
-    CHECK_THROWS_AS("{'abc'"_re, RegexParserException);
-    CHECK_THROWS_AS("{"_re, RegexParserException);
-    CHECK_THROWS_AS("}"_re, RegexParserException);
-    CHECK_THROWS_AS("{{{'abc'"_re, RegexParserException);
-    CHECK_THROWS_AS("'abc'}}}"_re, RegexParserException);
+    CHECK_THROWS_AS(Regex{"{'abc'"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"{"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"}"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"{{{'abc'"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"'abc'}}}"}, RegexParserException);
   }
 }
 
@@ -104,10 +137,10 @@ TEST_CASE("Regex: Quantifier plus") {
   }
 
   SECTION("Invalid") {
-    CHECK_THROWS_AS("+"_re, RegexParserException);
-    CHECK_THROWS_AS("++"_re, RegexParserException);
-    CHECK_THROWS_AS("+a"_re, RegexParserException);
-    CHECK_THROWS_AS("{}+"_re, RegexParserException);
+    CHECK_THROWS_AS(Regex{"+"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"++"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"+a"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"{}+"}, RegexParserException);
   }
 }
 
@@ -121,10 +154,10 @@ TEST_CASE("Regex: Quantifier kleene") {
   }
 
   SECTION("Invalid") {
-    CHECK_THROWS_AS("*"_re, RegexParserException);
-    CHECK_THROWS_AS("***"_re, RegexParserException);
-    CHECK_THROWS_AS("*a"_re, RegexParserException);
-    CHECK_THROWS_AS("{}*"_re, RegexParserException);
+    CHECK_THROWS_AS(Regex{"*"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"***"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"*a"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"{}*"}, RegexParserException);
   }
 }
 
@@ -138,10 +171,10 @@ TEST_CASE("Regex: Quantifier quest") {
   }
 
   SECTION("Invalid") {
-    CHECK_THROWS_AS("?"_re, RegexParserException);
-    CHECK_THROWS_AS("???"_re, RegexParserException);
-    CHECK_THROWS_AS("?a"_re, RegexParserException);
-    CHECK_THROWS_AS("{}?"_re, RegexParserException);
+    CHECK_THROWS_AS(Regex{"?"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"???"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"?a"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"{}?"}, RegexParserException);
   }
 }
 
@@ -154,21 +187,710 @@ TEST_CASE("Regex: Alternative") {
     CHECK("a{a|'_'|n}*"_re.match("snake_case_variable123"));
   }
 
+  SECTION("Chained") {
+    // Chained alternatives share their root, with the priorities of nested ones
+    RegexAutomata chained = RegexParser{"'a'|'ab'|'abc'|n"}.parse();
+    RegexAutomata nested = RegexParser{"{{'a'|'ab'}|'abc'}|n"}.parse();
+    CHECK(chained.size() + 2 == nested.size());
+
+    for (std::string_view expression : {"a", "ab", "abc", "1", "x", ""}) {
+      CHECK(RegexNfa{chained}.run(expression.begin(), expression.end()) ==
+            RegexNfa{nested}.run(expression.begin(), expression.end()));
+    }
+
+    CHECK("'x' {'a'|'b'|'c'}+ 'y'"_re.match("xabcacby").length == 8);
+    CHECK("'a'|'b' 'c'|'d'"_re.match("ad"));
+  }
+
   SECTION("Invalid") {
-    CHECK_THROWS_AS("|"_re, RegexParserException);
-    CHECK_THROWS_AS("||"_re, RegexParserException);
-    CHECK_THROWS_AS("|||"_re, RegexParserException);
+    CHECK_THROWS_AS(Regex{"|"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"||"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"|||"}, RegexParserException);
 
-    CHECK_THROWS_AS("'a'|{}"_re, RegexParserException);
-    CHECK_THROWS_AS("{}|'b'"_re, RegexParserException);
-    CHECK_THROWS_AS("'a'|"_re, RegexParserException);
-    CHECK_THROWS_AS("|'b'"_re, RegexParserException);
+    CHECK_THROWS_AS(Regex{"'a'|{}"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"{}|'b'"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"'a'|"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"|'b'"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"'x' 'a'|"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"'x' {'a'|}"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"'x' {|'b'}"}, RegexParserException);
+    CHECK_THROWS_AS(Regex{"'a'|'b'|"}, RegexParserException);
   }
 }
 
 TEST_CASE("Regex: Wave") {
   CHECK("{'a'~'f'}"_re.match("abcdef"));
-  CHECK_THROWS_AS("{'a'~{}}"_re.match("abcdef"), RegexParserException);
+  CHECK_THROWS_AS(Regex{"{'a'~{}}"}.match("abcdef"), RegexParserException);
+}
+
+TEST_CASE("Regex: Compile time") {
+  constexpr auto identifier = "a{a|'_'|n}*"_re;
+  static_assert(identifier.match("snake_case_variable123").length == 22);
+  static_assert(!"'true'|'false'"_re.match("maybe"));
+
+  SECTION("Runtime equivalence") {
+    for (std::string_view expression : {"snake_case", "_snake", "a-b", ""}) {
+      RegexMatch expected = Regex{identifier.pattern()}.match(expression);
+      RegexMatch match = identifier.match(expression);
+      CHECK(expected.matched == match.matched);
+      CHECK(expected.length == match.length);
+    }
+  }
+}
+
+TEST_CASE("Regex: Automata storage") {
+  Regex regex{"{'-'|'+'}? n+ {'.' n+}? a*"};
+  RegexAutomata copy = regex.automata();
+
+  for (size_t id = 0; id < copy.size(); id++) {
+    INFO("node " << id);
+    CHECK(std::ranges::is_sorted(copy.edges(id)));
+    CHECK(std::ranges::equal(copy.edges(id), regex.automata().edges(id)));
+  }
+
+  for (std::string_view expression : {"-12.5e", "+7", "3.", "abc"}) {
+    CHECK(RegexNfa{copy}.run(expression.begin(), expression.end()).length ==
+          regex.match(expression).length);
+  }
+}
+
+// Backtracking over the automata, the reference implementation of the dfa and the nfa
+template <typename Iterator>
+RegexMatch backtrack(const RegexAutomata &automata, Iterator begin, Iterator input, Iterator end,
+                     size_t id = 0) {
+  const RegexNode &node = automata.node(id);
+
+  if (node.state.type == REGEX_EPSILON || (input != end && automata.accepts(id, *input))) {
+    Iterator output = (node.state.type != REGEX_EPSILON) ? input + 1 : input;
+
+    for (size_t edge : automata.edges(id)) {
+      if (RegexMatch match = backtrack(automata, begin, output, end, edge)) return match;
+    }
+
+    if (node.state.type != REGEX_ANY && automata.is_leaf(id)) {
+      return {true, (size_t)std::distance(begin, output)};
+    }
+  }
+
+  return {false, (size_t)std::distance(begin, input)};
+}
+
+inline bool dfa_equivalent(const Regex &regex, std::string_view expression) {
+  for (size_t n = 0; n <= expression.size(); n++) {
+    auto begin = expression.begin(), end = expression.begin() + n;
+    const RegexAutomata &automata = regex.automata();
+
+    RegexMatch expected = !automata.empty() ? backtrack(automata, begin, begin, end)
+                                            : RegexMatch{false, 0};
+
+    std::vector<RegexMatch> matches{regex.dfa().run(begin, end),
+                                    RegexNfa{automata}.run(begin, end)};
+    if (regex.glushkov() != nullptr) matches.push_back(regex.glushkov()->run(begin, end));
+
+    for (RegexMatch match : matches) {
+      if (expected.matched != match.matched) return false;
+      if (expected.matched && expected.length != match.length) return false;
+    }
+  }
+
+  return true;
+}
+
+TEST_CASE("Regex: DFA equivalence") {
+  const std::pair<std::string_view, std::vector<std::string_view>> cases[] = {
+      {"'abc'", {"abc", "abcccccccccc", "cba", "ab"}},
+      {"'hello' ' ' 'world'", {"hello world", "hello  world"}},
+      {"_", {"\n", "b"}},
+      {"a", {"a", "4"}},
+      {"o", {"+", "\t"}},
+      {"n", {"7", "|"}},
+      {"Q", {"\"", "^"}},
+      {"q", {"'", "&"}},
+      {"{'ab'} {'c'}", {"abc", "abd"}},
+      {"{{{{{{'ab'} {'c'}}}}}}", {"abc"}},
+      {"{'abc'}+", {"abcabcabc", "abcab", ""}},
+      {"{'ab'n}+", {"ab1ab2ab3", "ab1abc"}},
+      {"n+n+", {"12", "1", "123456"}},
+      {"{'abc'}*", {"abc", "", "abcabcab"}},
+      {"{'ab'n}*", {"ab1ab2ab3", "ab"}},
+      {"{{{'hello'}}}*", {"", "hellohellohello", "hellohel"}},
+      {"{'abc'}?", {"abc", "", "ab"}},
+      {"{'ab'n}?", {"ab1", "abc"}},
+      {"{'a'|'b'}", {"a", "b", "c"}},
+      {"a{a|'_'|n}*", {"snake_case_variable123", "_snake", "a-b"}},
+      {"{'a'~'f'}", {"abcdef", "abcdefabcdef", "abcde"}},
+      {"{'-'|'+'}? n+ '.' n+ 'f'?", {"1.0f", "-13243.43934", "0.f", "95435"}},
+      {"'true'|'false'", {"true", "false", "'true'"}},
+      {"q^q", {"'a'", "'''", "'b", "'hello world'"}},
+      {"Q~Q", {"\"hello world\"", "\"hello\nworld\" \"\"", "hello", "\""}},
+  };
+
+  for (const auto &[pattern, expressions] : cases) {
+    Regex regex{pattern};
+
+    for (std::string_view expression : expressions) {
+      INFO(pattern << " on " << quoted(expression));
+      CHECK(dfa_equivalent(regex, expression));
+    }
+  }
+
+  CHECK(dfa_equivalent(Regex(quoted(LOREM_IPSUM)), LOREM_IPSUM));
+}
+
+TEST_CASE("Regex: Minimization") {
+  SECTION("Merged states") {
+    RegexAutomata automata = RegexParser{"{'ab'|'cb'} n*"}.parse();
+    RegexDfa dfa{automata}, minimized = dfa.minimize();
+
+    CHECK(minimized.size() < dfa.size());
+    CHECK(minimized.minimize().size() == minimized.size());
+
+    for (std::string_view expression : {"ab", "cb12", "ac", "abb", "cb1x", ""}) {
+      INFO(quoted(expression));
+      CHECK(minimized.run(expression.begin(), expression.end()) ==
+            dfa.run(expression.begin(), expression.end()));
+    }
+  }
+
+  SECTION("Patterns") {
+    std::vector<RegexAutomata> automatas{};
+    std::vector<const RegexAutomata *> pointers{};
+
+    for (std::string_view pattern : {"n+", "{'-'|'+'}? n+ '.' n+", "a{a|n}*", "'true'"}) {
+      automatas.push_back(RegexParser{pattern}.parse());
+    }
+    for (const RegexAutomata &automata : automatas) pointers.push_back(&automata);
+
+    RegexDfa dfa{pointers}, minimized = dfa.minimize();
+    CHECK(minimized.size() <= dfa.size());
+
+    for (std::string_view expression : {"12", "-1.5", "true", "trueish", "t", "1.", "+"}) {
+      INFO(quoted(expression));
+      CHECK(minimized.run(expression.begin(), expression.end()) ==
+            dfa.run(expression.begin(), expression.end()));
+    }
+  }
+}
+
+TEST_CASE("Regex: Cache") {
+  RegexCacheStats before = RegexCache::global().stats();
+  Regex regex{"n+ 'cached'"}, copy{"n+ 'cached'"};
+
+  CHECK(&regex.automata() == &copy.automata());
+  CHECK(RegexCache::global().stats().hits == before.hits + 1);
+  CHECK(RegexCache::global().stats().misses == before.misses + 1);
+  CHECK(RegexCache::global().stats().minimized <= RegexCache::global().stats().states);
+  CHECK(copy.match("12cached"));
+
+  SECTION("Threads") {
+    std::vector<std::thread> threads{};
+    std::vector<const RegexDfa *> dfas(8);
+
+    for (size_t i = 0; i < dfas.size(); i++) {
+      threads.emplace_back([&dfas, i] { dfas[i] = &Regex{"a+ 'threaded'"}.dfa(); });
+    }
+    for (std::thread &thread : threads) thread.join();
+
+    CHECK(std::all_of(dfas.begin(), dfas.end(), [&](auto dfa) { return dfa == dfas.front(); }));
+  }
+}
+
+TEST_CASE("Regex: Cache eviction") {
+  RegexCache cache{2};
+  std::weak_ptr<const RegexProgram> first = cache.compile("'first'");
+  std::shared_ptr<const RegexProgram> second = cache.compile("'second'");
+  std::string_view expression = "second";
+
+  // The least recently used program is evicted, and released once no regex holds it
+  CHECK(cache.compile("'first'") == first.lock());
+  cache.compile("'third'");
+  CHECK(cache.size() == 2);
+  CHECK(cache.stats().evictions == 1);
+  CHECK_FALSE(first.expired());
+
+  cache.compile("'fourth'");
+  CHECK(first.expired());
+  CHECK(cache.stats().evictions == 2);
+
+  // Evicted programs held by a regex stay valid, the pattern is compiled again
+  CHECK(second->dfa.run(expression.begin(), expression.end()));
+  CHECK(cache.compile("'second'") != second);
+  CHECK(cache.stats().misses == 5);
+}
+
+// Reference search trying every position in turn
+inline RegexMatch naive_search(const Regex &regex, std::string_view expression, size_t from) {
+  for (size_t position = from; position <= expression.size(); position++) {
+    RegexMatch match = regex.match(expression.substr(position));
+    if (match) return {true, match.length, match.pattern, position};
+  }
+
+  return {false, 0};
+}
+
+TEST_CASE("Regex: Search") {
+  SECTION("Leftmost") {
+    Regex booleans{"'true'|'false'"};
+    RegexMatch match = booleans.search("x: false, y: true");
+
+    CHECK((match && match.position == 3 && match.length == 5));
+    CHECK(booleans.search("x: false, y: true", 4).position == 13);
+    CHECK_FALSE(booleans.search("x: fals, y: tru"));
+    CHECK(Regex{"n+"}.search("abc 12345 6").length == 5);
+
+    // The first alternative matching at the position is taken, not the longest one
+    CHECK(Regex{"'a'|'ab'"}.search("cab") == RegexMatch{true, 1, 0, 1});
+  }
+
+  SECTION("Prefixes") {
+    const std::pair<std::string_view, std::string_view> cases[] = {
+        {"'key' ':' _* n+", "ke key:x key:  42 key"},
+        {"'a' n", "aaaa a1"},
+        {"'true'|'false'", "tru fals ftrue"},
+        {"{'-'|'+'}? n+ '.' n+", "1. -2 +3.5 6"},
+        {"n*", "ab12"},
+        {"Q~Q", "\"unterminated \"a\" \"b"},
+    };
+
+    for (const auto &[pattern, expression] : cases) {
+      Regex regex{pattern};
+
+      for (size_t from = 0; from <= expression.size(); from++) {
+        INFO(pattern << " on " << quoted(expression) << " from " << from);
+        CHECK(regex.search(expression, from) == naive_search(regex, expression, from));
+      }
+    }
+
+    CHECK(Regex{"'key' ':'"}.search("").matched == false);
+    CHECK(Regex{"n*"}.search("").matched);
+  }
+
+  SECTION("Priorities") {
+    const std::pair<std::string_view, std::string_view> cases[] = {
+        {"'abcd'|'c'", "xabcd abce"},
+        {"'a'|'ab'", "cab ab"},
+        {"'ab'? 'b'", "abb b ab"},
+        {"'a'~'b'", "aacab aab"},
+        {"{a|'_'}{a|'_'|n}* '('?", "1 snake_2( x"},
+        {"n+ {'.' n+}?", "v1.2. 33.x"},
+        {"'x'* 'y'", "xxz xxxy"},
+        {"_ 'a'", "aaa ba"},
+    };
+
+    for (const auto &[pattern, expression] : cases) {
+      Regex regex{pattern};
+
+      for (size_t from = 0; from <= expression.size(); from++) {
+        INFO(pattern << " on " << quoted(expression) << " from " << from);
+        CHECK(regex.search(expression, from) == naive_search(regex, expression, from));
+      }
+    }
+  }
+
+  SECTION("Linear time") {
+    // Restarting the match at every position would rescan the rest of the input each time
+    Regex regex{"'a'~'b'"};
+    std::string expression(1 << 18, 'a');
+
+    auto start = std::chrono::steady_clock::now();
+    RegexMatch anchored = regex.match(expression);
+    auto matched = std::chrono::steady_clock::now();
+    RegexMatch found = regex.search(expression);
+    auto searched = std::chrono::steady_clock::now();
+
+    CHECK_FALSE(anchored);
+    CHECK_FALSE(found);
+    CHECK(searched - matched < 64 * (matched - start) + std::chrono::milliseconds{50});
+
+    expression.back() = 'b';
+    CHECK(regex.search(expression) == RegexMatch{true, expression.size(), 0, 0});
+  }
+
+  SECTION("Find all") {
+    std::string buffer{};
+    for (size_t i = 0; i < 1000; i++) buffer += "name: \"record\", visible: true, id: 12\n";
+
+    size_t count = 0;
+    for (const RegexMatch &match : Regex{"'true'|'false'"}.find_all(buffer)) {
+      CHECK(buffer.substr(match.position, match.length) == "true");
+      count++;
+    }
+
+    CHECK(count == 1000);
+
+    std::vector<size_t> positions{};
+    for (const RegexMatch &match : Regex{"n*"}.find_all("a12b")) {
+      positions.push_back(match.position);
+    }
+    CHECK(positions == std::vector<size_t>{0, 1, 3, 4});
+  }
+}
+
+TEST_CASE("Regex: Jit") {
+  SECTION("Patterns") {
+    const std::pair<std::string_view, std::vector<std::string>> cases[] = {
+        {"'abc'", {"abc", "abcc", "ab", ""}},
+        {"n+", {"12345", "1a", "a"}},
+        {"{'-'|'+'}? n+ '.' n+ 'f'?", {"-1.5f", "1.", "+0.25x"}},
+        {"Q~Q", {"\"" + std::string(100, 'x') + "\" tail", "\"\xe9\xff\"", "\"open"}},
+        {"_+", {std::string(70, ' ') + "x", "\t\n"}},
+        {"n*", {"", "x", "42"}},
+    };
+
+    for (const auto &[pattern, expressions] : cases) {
+      Regex regex{pattern};
+
+      for (std::string_view expression : expressions) {
+        INFO(pattern << " on " << quoted(expression));
+        CHECK(regex.jit().run(expression.begin(), expression.end()) ==
+              regex.dfa().run(expression.begin(), expression.end()));
+      }
+    }
+  }
+
+  SECTION("Null view") {
+    std::string_view empty{};
+
+    for (std::string_view pattern : {"n*", "'a'?", "'a'"}) {
+      Regex regex{pattern};
+      INFO(pattern);
+      CHECK(regex.jit().run(empty.begin(), empty.end()) ==
+            regex.dfa().run(empty.begin(), empty.end()));
+    }
+
+    CHECK(Regex{"n*"}.jit().run(empty.begin(), empty.end()) == RegexMatch{true, 0, 0});
+  }
+
+  SECTION("Token lexer") {
+    std::string_view source = "name: \"sdata\", version: -1.0f, ready: true, id: 0042 'c' @";
+
+    for (size_t i = 0; i <= source.size(); i++) {
+      INFO(source.substr(i));
+      CHECK(token_lexer_jit().run(source.begin() + i, source.end()) ==
+            s_token_lexer.run(source.begin() + i, source.end()));
+    }
+
+    std::u16string wide = u"name";
+    CHECK(token_lexer_jit().run(wide.begin(), wide.end()) ==
+          s_token_lexer.run(wide.begin(), wide.end()));
+  }
+}
+
+// Records of quoted values, their dfa grows exponentially with the count
+inline std::pair<std::string, std::string> lazy_records(size_t count) {
+  std::string pattern{}, expression{};
+
+  for (size_t i = 0; i < count; i++) {
+    pattern += "'k=' Q~Q ';' ";
+    expression += "k=\"v;" + std::to_string(i) + "\";";
+  }
+
+  return {pattern, expression};
+}
+
+TEST_CASE("Regex: Lazy dfa") {
+  SECTION("Equivalence") {
+    const std::pair<std::string_view, std::vector<std::string>> cases[] = {
+        {"'abc'", {"abc", "abcc", "ab", ""}},
+        {"{'-'|'+'}? n+ '.' n+ 'f'?", {"-1.5f", "1.", "+0.25x"}},
+        {"Q~Q _* ',' Q~Q", {"\"a\", \"b\"", "\"a\" \"b\"", "\"\xe9\",\"\""}},
+        {"{a|'_'}{a|'_'|n}*", {"snake_case_42", "_", "4x"}},
+        {"n*", {"", "x", "42"}},
+    };
+
+    // The smallest cache flushes on most transitions
+    for (size_t states : {RegexLazyDfa::MIN_STATES, RegexLazyDfa::STATES}) {
+      for (const auto &[pattern, expressions] : cases) {
+        RegexAutomata automata = RegexParser{pattern}.parse();
+        RegexDfa dfa{automata};
+        RegexLazyDfa lazy{automata, states};
+
+        for (size_t round = 0; round < 2; round++) {
+          for (std::string_view expression : expressions) {
+            INFO(pattern << " on " << quoted(expression) << " with " << states << " states");
+            CHECK(lazy.run(expression.begin(), expression.end()) ==
+                  dfa.run(expression.begin(), expression.end()));
+          }
+        }
+
+        CHECK(lazy.size() <= states);
+      }
+    }
+  }
+
+  SECTION("Blow up") {
+    RegexCacheStats before = RegexCache::global().stats();
+    auto [pattern, expression] = lazy_records(16);
+    Regex regex{pattern};
+
+    REQUIRE(regex.lazy() != nullptr);
+    CHECK(regex.dfa().empty());
+    CHECK(RegexCache::global().stats().lazy == before.lazy + 1);
+
+    RegexMatch expected = regex.match(expression, RegexBudget{});
+    CHECK(expected.length == expression.size());
+    CHECK(regex.match(expression) == expected);
+    CHECK(regex.jit().run(expression.begin(), expression.end()) == expected);
+
+    std::string text = "ab " + expression + " " + expression;
+    CHECK(regex.search(text) == RegexMatch{true, expression.size(), 0, 3});
+
+    size_t count = 0;
+    for (const RegexMatch &match : regex.find_all(text)) count += match.length == expected.length;
+    CHECK(count == 2);
+  }
+
+  SECTION("Bounded cache") {
+    auto [pattern, expression] = lazy_records(16);
+    RegexAutomata automata = RegexParser{pattern}.parse();
+    RegexLazyDfa lazy{automata, RegexLazyDfa::MIN_STATES};
+
+    CHECK(lazy.run(expression.begin(), expression.end()) ==
+          RegexNfa{automata}.run(expression.begin(), expression.end()));
+    CHECK(lazy.size() <= RegexLazyDfa::MIN_STATES);
+    CHECK(lazy.stats().flushes > 0);
+    CHECK(lazy.stats().fallbacks == 1);
+  }
+
+  SECTION("Linear search") {
+    RegexAutomata automata = RegexParser{"'a'~'b'"}.parse();
+    RegexLazyDfa lazy{automata};
+    RegexSearcher searcher{automata, RegexDfaView{}, 0};
+    std::string expression(1 << 18, 'a');
+
+    auto start = std::chrono::steady_clock::now();
+    RegexMatch anchored = lazy.run(expression.begin(), expression.end());
+    auto matched = std::chrono::steady_clock::now();
+    RegexMatch found = searcher.search(expression, 0);
+    auto searched = std::chrono::steady_clock::now();
+
+    CHECK_FALSE(anchored);
+    CHECK_FALSE(found);
+    CHECK(searched - matched < 64 * (matched - start) + std::chrono::milliseconds{50});
+
+    expression.back() = 'b';
+    CHECK(searcher.search(expression, 1) == RegexMatch{true, expression.size() - 1, 0, 1});
+  }
+
+  SECTION("Threads") {
+    auto [pattern, expression] = lazy_records(12);
+    Regex regex{pattern};
+    std::vector<std::thread> threads{};
+    std::vector<RegexMatch> matches(8);
+
+    for (size_t i = 0; i < matches.size(); i++) {
+      threads.emplace_back([&, i] {
+        matches[i] = i % 2 ? regex.match(expression.substr(i)) : regex.search(expression);
+      });
+    }
+    for (std::thread &thread : threads) thread.join();
+
+    for (size_t i = 0; i < matches.size(); i++) {
+      std::string input = expression.substr(i % 2 ? i : 0);
+      CHECK(matches[i] == regex.match(input, RegexBudget{}));
+    }
+  }
+}
+
+TEST_CASE("Regex: Images") {
+  SECTION("Round trip") {
+    Regex regex{"{'-'|'+'}? n+ '.' n+ 'f'?"};
+    std::vector<std::byte> image = regex_write_image(regex.dfa().view());
+    RegexDfaView dfa = regex_read_image(image);
+
+    CHECK(dfa.size() == regex.dfa().size());
+    for (std::string_view expression : {"-1.5f", "1.", "+0.25x", "  0.5"}) {
+      CHECK(dfa.run(expression.begin(), expression.end()) == regex.match(expression));
+    }
+
+    // Multi pattern dfas keep the accepted pattern of each state
+    std::vector<std::byte> lexer = regex_write_image(s_token_lexer);
+    std::string_view source = "name: \"sdata\", version: -1.0f, ready: true, id: 0042 'c' @";
+    RegexDfaView loaded = regex_read_image(lexer);
+
+    for (size_t i = 0; i <= source.size(); i++) {
+      CHECK(loaded.run(source.begin() + i, source.end()) ==
+            s_token_lexer.run(source.begin() + i, source.end()));
+    }
+  }
+
+  SECTION("Files") {
+    std::string path = (std::filesystem::temp_directory_path() / "sdata_regex_image").string();
+    std::vector<std::byte> image = regex_write_image(s_token_lexer);
+    std::ofstream{path, std::ios::binary}.write(reinterpret_cast<const char *>(image.data()),
+                                                image.size());
+
+    {
+      RegexImageFile file{path};
+      std::string_view expression = "identifier: 42";
+      CHECK(file.dfa().run(expression.begin(), expression.end()) ==
+            s_token_lexer.run(expression.begin(), expression.end()));
+    }
+
+    std::filesystem::remove(path);
+    CHECK_THROWS_AS(RegexImageFile{path}, RegexImageException);
+  }
+
+  SECTION("Malformed") {
+    std::vector<std::byte> image = regex_write_image(Regex{"'abc'"}.dfa().view());
+    auto corrupted = [&image](size_t offset, std::byte value) {
+      std::vector<std::byte> copy = image;
+      copy[offset] = value;
+      return copy;
+    };
+
+    CHECK_THROWS_AS(regex_read_image({}), RegexImageException);
+    CHECK_THROWS_AS(regex_read_image(std::span{image}.first(image.size() - 1)),
+                    RegexImageException);
+    CHECK_THROWS_AS(regex_read_image(corrupted(0, std::byte{'X'})), RegexImageException);
+
+    // Highest byte of the last transition of the first state after the dead one
+    size_t transition = sizeof(RegexImageHeader) + 2 * RegexDfaView::ALPHABET * 4 - 1;
+    CHECK_THROWS_AS(regex_read_image(corrupted(transition, std::byte{0xff})), RegexImageException);
+
+    // Lowest byte of the pattern accepted by each accepting state, a single pattern image has one
+    RegexDfaView view = Regex{"'abc'"}.dfa().view();
+    for (RegexDfaView::State state = 0; state < view.size(); state++) {
+      if (!view.accepts(state)) continue;
+
+      size_t accepted = sizeof(RegexImageHeader) + view.size() * RegexDfaView::ALPHABET * 4;
+      accepted += state * 4;
+      CHECK_NOTHROW(regex_read_image(corrupted(accepted, std::byte{0})));
+      CHECK_THROWS_AS(regex_read_image(corrupted(accepted, std::byte{1})), RegexImageException);
+    }
+
+    std::vector<uint32_t> shifted((image.size() + 8) / 4);
+    std::memcpy(reinterpret_cast<std::byte *>(shifted.data()) + 1, image.data(), image.size());
+    CHECK_THROWS_AS(
+        regex_read_image({reinterpret_cast<const std::byte *>(shifted.data()) + 1, image.size()}),
+        RegexImageException);
+  }
+}
+
+TEST_CASE("Regex: Glushkov") {
+  SECTION("Selection") {
+    for (TokenCategory category : {TOKEN_SEPARATOR, TOKEN_BOOL, TOKEN_ID, TOKEN_INT, TOKEN_EMPTY}) {
+      INFO(category);
+      CHECK(Regex{token_pattern(category).pattern()}.glushkov() != nullptr);
+    }
+
+    // The first alternative and the first closing quote match first, longest matches differ
+    CHECK(Regex{"{'a'|'ab'}"}.glushkov() == nullptr);
+    CHECK(Regex{"Q~Q"}.glushkov() == nullptr);
+    CHECK(Regex{"{'a'|'ab'}"}.match("ab").length == 1);
+    CHECK(Regex(quoted(LOREM_IPSUM)).glushkov() == nullptr);
+  }
+
+  SECTION("Matching") {
+    Regex identifier{"{a|'_'} {a|n|'_'}*"};
+    REQUIRE(identifier.glushkov() != nullptr);
+
+    CHECK(identifier.match("snake_case_42 tail").length == 13);
+    CHECK_FALSE(identifier.match("42"));
+
+    std::u16string wide = u"\u00e9t\u00e9_ tail";
+    CHECK(identifier.match(wide.begin(), wide.end()) == RegexMatch{false, 0, RegexDfaView::REJECT});
+    CHECK(identifier.match(wide.begin() + 1, wide.end()) == RegexMatch{true, 1, 0});
+  }
+}
+
+TEST_CASE("Regex: Profile") {
+  SECTION("Counters") {
+    Regex digits{"n+"};
+    RegexProfile profile = digits.profile("12345x");
+    size_t visits = 0, follows = 0;
+
+    for (size_t count : profile.nodes) visits += count;
+    for (size_t count : profile.edges) follows += count;
+
+    CHECK(visits == 6);
+    CHECK(follows >= 5);
+    CHECK(profile.cuts == 0);
+    CHECK(Regex{"{'a'|'ab'}"}.profile("ab").cuts > 0);
+  }
+
+  SECTION("Heat map") {
+    Regex identifier{"a{a|n|'_'}*"};
+    std::stringstream stream{};
+    RegexGraphviz{identifier.automata(), identifier.profile("snake_case")}.stream(stream);
+
+    CHECK(stream.str().find("fillcolor") != std::string::npos);
+    CHECK(stream.str().find("penwidth") != std::string::npos);
+    CHECK(stream.str().find("# cuts: ") != std::string::npos);
+  }
+}
+
+TEST_CASE("Regex: NFA simulation") {
+  SECTION("Long input") {
+    std::string expression = '"' + std::string(1 << 20, 'x') + '"';
+    RegexMatch match = RegexNfa{Regex{"Q~Q"}.automata()}.run(expression.begin(), expression.end());
+    CHECK(match.matched);
+    CHECK(match.length == expression.size());
+  }
+
+  SECTION("Budget") {
+    Regex regex{"Q~Q"};
+    std::string expression = '"' + std::string(1 << 16, 'x');
+
+    CHECK_THROWS_AS(regex.match(expression, RegexBudget{.steps = 1000}), RegexBudgetException);
+    CHECK_FALSE(regex.match(expression, RegexBudget{.steps = 1 << 20}));
+    CHECK(regex.match(expression + '"', RegexBudget{}).length == expression.size() + 1);
+  }
+
+  SECTION("Setup") {
+    std::string pattern{};
+    for (size_t i = 0; i < 64; i++) {
+      pattern += (i > 0 ? "|'setup_" : "'setup_") + std::to_string(i) + "'";
+    }
+
+    Regex regex{pattern};
+    size_t nodes = regex.automata().size();
+
+    // The first match copies the closure builder, later ones reuse it
+    CHECK_THROWS_AS(regex.match("setup_7", RegexBudget{.steps = nodes / 2}), RegexBudgetException);
+    CHECK(regex.match("setup_7", RegexBudget{.steps = 2 * nodes}).length == 7);
+    CHECK(regex.match("setup_9", RegexBudget{.steps = nodes}).length == 7);
+  }
+}
+
+TEST_CASE("Regex: Skip kernels") {
+  SECTION("Ranges") {
+    RegexSkip digits = RegexSkip::of([](size_t byte) { return byte >= '0' && byte <= '9'; });
+    RegexSkip body = RegexSkip::of([](size_t byte) { return byte != '"'; });
+    RegexSkip scattered = RegexSkip::of([](size_t byte) { return byte % 2 == 0; });
+
+    CHECK((digits.active() && !digits.negated && digits.count == 1));
+    CHECK((body.active() && body.negated && body.count == 1));
+    CHECK_FALSE(scattered.active());
+  }
+
+  SECTION("Kernels") {
+    RegexSkip identifier = RegexSkip::of([](size_t byte) {
+      return std::isalnum(static_cast<int>(byte)) || byte == '_';
+    });
+    RegexSkip body = RegexSkip::of([](size_t byte) { return byte != '"'; });
+
+    for (size_t length : {0, 1, 15, 16, 17, 31, 32, 33, 100}) {
+      std::string identifiers = std::string(length, 'x') + " tail";
+      std::string string = std::string(length, '\xe9') + "\" tail";
+
+      INFO("length " << length);
+      CHECK(regex_skip(identifiers.data(), identifiers.data() + identifiers.size(), identifier) ==
+            identifiers.data() + length);
+      CHECK(regex_skip(string.data(), string.data() + string.size(), body) ==
+            string.data() + length);
+      CHECK(regex_skip(string.data(), string.data() + length, body) == string.data() + length);
+    }
+  }
+
+  SECTION("Dfa") {
+    std::string string = '"' + std::string(1000, 'x') + "\" tail";
+    std::string blank = std::string(1000, ' ') + "x";
+
+    CHECK("Q~Q"_re.match(string).length == 1002);
+    CHECK("_+"_re.match(blank).length == 1000);
+    CHECK("a{a|n|'_'}*"_re.match(std::string(1000, 'a') + "-").length == 1000);
+  }
 }
 
 #endif
@@ -2,13 +2,14 @@
 #define SDATA_SCANNER_TEST_HPP
 
 #include <catch2/catch.hpp>
+#include <sstream>
 #include <sdata/sdata.hpp>
 
 using namespace sdata;
 
 TEST_CASE("Scanner<char> patterns") {
   SECTION("EMPTY") {
-    const auto &empty_pattern = s_token_patterns.at(TOKEN_EMPTY);
+    const auto &empty_pattern = token_pattern(TOKEN_EMPTY);
     CHECK(empty_pattern.match(" "));
     CHECK(empty_pattern.match("   "));
     CHECK(empty_pattern.match("\n "));
@@ -17,14 +18,14 @@ TEST_CASE("Scanner<char> patterns") {
   }
 
   SECTION("STRING") {
-    const auto &string_pattern = s_token_patterns.at(TOKEN_STRING);
+    const auto &string_pattern = token_pattern(TOKEN_STRING);
     CHECK(string_pattern.match("\"hello world\""));
     CHECK(string_pattern.match("\"hello\nworld\""));
     CHECK_FALSE(string_pattern.match("hello"));
   }
 
   SECTION("CHARACTER") {
-    const auto &character_pattern = s_token_patterns.at(TOKEN_CHAR);
+    const auto &character_pattern = token_pattern(TOKEN_CHAR);
     CHECK(character_pattern.match("'a'"));
     CHECK(character_pattern.match("'@'"));
     CHECK(character_pattern.match("'\''"));
@@ -34,14 +35,14 @@ TEST_CASE("Scanner<char> patterns") {
   }
 
   SECTION("BOOLEAN") {
-    const auto &boolean_pattern = s_token_patterns.at(TOKEN_BOOL);
+    const auto &boolean_pattern = token_pattern(TOKEN_BOOL);
     CHECK(boolean_pattern.match("true"));
     CHECK(boolean_pattern.match("false"));
     CHECK_FALSE(boolean_pattern.match("'true'"));
   }
 
   SECTION("FLOAT") {
-    const auto &float_pattern = s_token_patterns.at(TOKEN_FLOAT);
+    const auto &float_pattern = token_pattern(TOKEN_FLOAT);
     CHECK(float_pattern.match("1.0f"));
     CHECK(float_pattern.match("13243.43934f"));
     CHECK(float_pattern.match("0.0003923423493423f"));
@@ -52,14 +53,24 @@ TEST_CASE("Scanner<char> patterns") {
   }
 
   SECTION("INTEGER") {
-    const auto &integer_pattern = s_token_patterns.at(TOKEN_INT);
+    const auto &integer_pattern = token_pattern(TOKEN_INT);
     CHECK(integer_pattern.match("1"));
     CHECK(integer_pattern.match("134342"));
     CHECK(integer_pattern.match("00313134"));
   }
 
+  SECTION("SIZED NUMBERS") {
+    CHECK(token_pattern(TOKEN_DOUBLE).match("0.1d"));
+    CHECK(token_pattern(TOKEN_DOUBLE).match("-123456789.123456789d"));
+    CHECK_FALSE(token_pattern(TOKEN_DOUBLE).match("0.1"));
+    CHECK(token_pattern(TOKEN_INT64).match("-9223372036854775808l"));
+    CHECK_FALSE(token_pattern(TOKEN_INT64).match("12"));
+    CHECK(token_pattern(TOKEN_UINT64).match("+18446744073709551615u"));
+    CHECK_FALSE(token_pattern(TOKEN_UINT64).match("-1u"));
+  }
+
   SECTION("IDENTIFIER") {
-    const auto &identifier_pattern = s_token_patterns.at(TOKEN_ID);
+    const auto &identifier_pattern = token_pattern(TOKEN_ID);
     CHECK(identifier_pattern.match("my_identifier"));
     CHECK(identifier_pattern.match("my_id_nb123"));
     CHECK_FALSE(identifier_pattern.match("@this_is_a_namespace_not_an_id"));
@@ -67,10 +78,10 @@ TEST_CASE("Scanner<char> patterns") {
   }
 
   SECTION("OPERATORS") {
-    CHECK(s_token_patterns.at(TOKEN_ASSIGN).match(":"));
-    CHECK(s_token_patterns.at(TOKEN_BEG_SEQ).match("{"));
-    CHECK(s_token_patterns.at(TOKEN_END_SEQ).match("}"));
-    CHECK(s_token_patterns.at(TOKEN_SEPARATOR).match(","));
+    CHECK(token_pattern(TOKEN_ASSIGN).match(":"));
+    CHECK(token_pattern(TOKEN_BEG_SEQ).match("{"));
+    CHECK(token_pattern(TOKEN_END_SEQ).match("}"));
+    CHECK(token_pattern(TOKEN_SEPARATOR).match(","));
   }
 }
 
@@ -81,6 +92,203 @@ bool token_matches(Scanner<CharT> &scanner,
   return expected.first == token.expression && expected.second == token.category;
 }
 
+TEST_CASE("Scanner<char> longest match") {
+  Scanner<char> scanner{"1.5 true trueish -12 falsehood"};
+
+  REQUIRE(token_matches(scanner, {"1.5", TOKEN_FLOAT}));
+  REQUIRE(token_matches(scanner, {"true", TOKEN_BOOL}));
+  REQUIRE(token_matches(scanner, {"trueish", TOKEN_ID}));
+  REQUIRE(token_matches(scanner, {"-12", TOKEN_INT}));
+  REQUIRE(token_matches(scanner, {"falsehood", TOKEN_ID}));
+  REQUIRE(scanner.tokenize().category == TOKEN_EOF);
+}
+
+TEST_CASE("Scanner<char> number suffixes") {
+  Scanner<char> scanner{"1.5f 1.5d 1.5 12l 12u 12 -12u"};
+
+  REQUIRE(token_matches(scanner, {"1.5f", TOKEN_FLOAT}));
+  REQUIRE(token_matches(scanner, {"1.5d", TOKEN_DOUBLE}));
+  REQUIRE(token_matches(scanner, {"1.5", TOKEN_FLOAT}));
+  REQUIRE(token_matches(scanner, {"12l", TOKEN_INT64}));
+  REQUIRE(token_matches(scanner, {"12u", TOKEN_UINT64}));
+  REQUIRE(token_matches(scanner, {"12", TOKEN_INT}));
+  REQUIRE(token_matches(scanner, {"-12", TOKEN_INT}));
+  REQUIRE(token_matches(scanner, {"u", TOKEN_ID}));
+}
+
+#ifdef SDATA_TOKEN_LEXER_GENERATED
+TEST_CASE("Scanner<char> generated lexer") {
+  std::string_view sources[] = {
+      "name: \"sdata\", version: -1.0f, ready: true, id: 0042",
+      "{ x: 'a', y: falsey, z: \"unterminated",
+      "   \n\t  ",
+      "1.",
+      "",
+  };
+
+  for (std::string_view source : sources) {
+    for (size_t i = 0; i <= source.size(); i++) {
+      INFO(source.substr(i));
+      CHECK(token_lexer_generated(source.begin() + i, source.end()) ==
+            s_token_lexer.run(source.begin() + i, source.end()));
+    }
+  }
+
+  std::u16string wide = u"ID: \"\u00e9t\u00e9\"";
+  CHECK(token_lexer_generated(wide.begin() + 4, wide.end()) ==
+        s_token_lexer.run(wide.begin() + 4, wide.end()));
+}
+#endif
+
+TEST_CASE("Scanner<char> source locations") {
+  std::string source{};
+  for (size_t record = 0; record < 20000; record++) source += "key: \"multi\nline\",\n\n";
+
+  Scanner<char> scanner{source};
+
+  for (size_t line = 0; line < 60000; line += 3) {
+    Token<char> key = scanner.tokenize();
+    REQUIRE(key.source_location.line == line);
+
+    if (line % 3000 == 0) {
+      CHECK(key.source_location.line == SourceLocation<char>{source, key.expression.begin()}.line);
+    }
+
+    scanner.tokenize();
+    CHECK(scanner.tokenize().source_location.line == line);
+    CHECK(scanner.tokenize().source_location.line == line + 1);
+  }
+
+  CHECK(scanner.tokenize().source_location.line == 60000);
+}
+
+TEST_CASE("Scanner<char> token buffer") {
+  std::string source = read_source_file<char>("examples/game.sd");
+  TokenBuffer<char> tokens = Scanner<char>{source}.tokenize_all();
+  Scanner<char> scanner{source};
+
+  for (size_t i = 0; i < tokens.size(); i++) {
+    Token<char> token = scanner.tokenize();
+    CHECK(tokens[i] == token);
+    CHECK(tokens[i].source_location.index == token.source_location.index);
+    CHECK(tokens[i].source_location.line == token.source_location.line);
+  }
+
+  CHECK(tokens.category(tokens.size() - 1) == TOKEN_EOF);
+  CHECK(tokens.expression(0) == "tetris");
+
+  // Long runs of blanks are skipped without recursion
+  std::string blanks = std::string(1 << 20, ' ') + "id";
+  CHECK(Scanner<char>{blanks}.tokenize_all().size() == 2);
+  CHECK(Scanner<char>{blanks}.tokenize().expression == "id");
+
+  CHECK_THROWS_AS(Scanner<char>{"id: 12 @"}.tokenize_all(), ScannerException<char>);
+}
+
+TEST_CASE("Scanner<char> parallel tokenization") {
+  auto same = [](const TokenBuffer<char> &tokens, const TokenBuffer<char> &expected) {
+    REQUIRE(tokens.size() == expected.size());
+
+    for (size_t i = 0; i < tokens.size(); i++) {
+      INFO("token " << i);
+      REQUIRE(tokens.offset(i) == expected.offset(i));
+      REQUIRE(tokens.length(i) == expected.length(i));
+      REQUIRE(tokens.category(i) == expected.category(i));
+      REQUIRE(tokens.line(i) == expected.line(i));
+    }
+  };
+
+  // Strings spanning chunks, with quotes and tokens inside, and quote characters out of strings
+  std::string source = "root: {\n";
+  for (size_t i = 0; i < 400; i++) {
+    source += "  key_" + std::to_string(i) + ": ";
+    switch (i % 5) {
+      case 0: source += "\"a string: {with, 'tokens'}\nover " + std::string(i, 'x') + "\""; break;
+      case 1: source += "'\"'"; break;
+      case 2: source += "-" + std::to_string(i) + ".5f"; break;
+      case 3: source += "{ a: true, b: '{' }"; break;
+      default: source += std::to_string(i); break;
+    }
+    source += ",\n";
+  }
+  source += "  end: 0\n}\n";
+
+  TokenBuffer<char> expected = Scanner<char>{source}.tokenize_all();
+
+  for (size_t threads : {2, 3, 8, 64}) {
+    for (size_t chunk : {1, 16, 500}) {
+      INFO(threads << " threads, chunks of " << chunk);
+      same(Scanner<char>{source}.tokenize_parallel(threads, chunk), expected);
+    }
+  }
+
+  // Small sources are tokenized sequentially
+  same(Scanner<char>{source}.tokenize_parallel(), expected);
+
+  // Errors are raised from the same token
+  std::string invalid = source + "@";
+  std::string message{};
+  try {
+    Scanner<char>{invalid}.tokenize_all();
+  } catch (const ScannerException<char> &exception) {
+    message = exception.what();
+  }
+
+  REQUIRE(!message.empty());
+  for (size_t chunk : {1, 16, 500}) {
+    try {
+      Scanner<char>{invalid}.tokenize_parallel(8, chunk);
+      FAIL("No exception raised");
+    } catch (const ScannerException<char> &exception) {
+      CHECK(exception.what() == message);
+    }
+  }
+}
+
+TEST_CASE("Scanner<char> streams") {
+  std::string source = read_source_file<char>("examples/game.sd");
+  source += "\nlong: \"" + std::string(100000, 'x') + "\"";
+
+  // Chunks of a single character cut every token
+  for (size_t chunk : {1, 7, 64, 4096}) {
+    std::istringstream stream{source};
+    StreamScanner<char> streamed{stream, chunk};
+    Scanner<char> scanner{source};
+
+    for (Token<char> token = scanner.tokenize(); token.category != TOKEN_EOF;) {
+      Token<char> other = streamed.tokenize();
+      INFO("chunk " << chunk << " at " << token.source_location.index);
+      REQUIRE(other == token);
+      REQUIRE(other.source_location.line == token.source_location.line);
+      token = scanner.tokenize();
+    }
+
+    CHECK(streamed.tokenize().category == TOKEN_EOF);
+    CHECK(streamed.tokenize().category == TOKEN_EOF);
+  }
+
+  std::istringstream invalid{"id: 12 @"};
+  StreamScanner<char> scanner{invalid, 2};
+  scanner.tokenize();
+  scanner.tokenize();
+  scanner.tokenize();
+  CHECK_THROWS_AS(scanner.tokenize(), ScannerException<char>);
+
+#ifdef SDATA_SCANNER_DESCRIPTORS
+  int descriptors[2];
+  REQUIRE(pipe(descriptors) == 0);
+  REQUIRE(write(descriptors[1], "id: 12", 6) == 6);
+  close(descriptors[1]);
+
+  StreamScanner<char> piped{descriptors[0], 4};
+  CHECK(piped.tokenize().expression == "id");
+  CHECK(piped.tokenize().category == TOKEN_ASSIGN);
+  CHECK(piped.tokenize().expression == "12");
+  CHECK(piped.tokenize().category == TOKEN_EOF);
+  close(descriptors[0]);
+#endif
+}
+
 TEST_CASE("Scanner<char>") {
   std::string source = read_source_file<char>("examples/game.sd");
   Scanner<char> scanner{source};
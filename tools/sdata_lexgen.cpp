@@ -0,0 +1,46 @@
+// Writes the token scanner header included by Scanner when SDATA_TOKEN_LEXER_GENERATED is defined.
+// The matcher is generated from s_token_lexer, token patterns stay defined in token.hpp only.
+
+#include <fstream>
+#include <iostream>
+#include "regex/regex_codegen.hpp"
+#include "token.hpp"
+
+constexpr std::string_view HEADER =
+    "// Generated by sdata_lexgen from sdata::s_token_patterns, do not edit\n"
+    "\n"
+    "#ifndef SDATA_TOKEN_LEXER_GENERATED_HPP\n"
+    "#define SDATA_TOKEN_LEXER_GENERATED_HPP\n"
+    "\n"
+    "#include <cstddef>\n"
+    "#include <iterator>\n"
+    "#include \"regex/regex_dfa.hpp\"\n"
+    "#include \"regex/regex_simd.hpp\"\n"
+    "#include \"token.hpp\"\n"
+    "\n"
+    "namespace sdata {\n"
+    "\n";
+
+constexpr std::string_view FOOTER =
+    "\n"
+    "}  // namespace sdata\n"
+    "\n"
+    "#endif\n";
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    std::cerr << "usage: sdata_lexgen <output header>" << std::endl;
+    return 1;
+  }
+
+  std::ofstream os{argv[1]};
+
+  os << HEADER;
+  os << "static_assert(token_patterns_hash() == " << sdata::token_patterns_hash() << "u,";
+  os << " \"Token patterns changed since the scanner was generated\");" << std::endl;
+  os << std::endl;
+  os << sdata::RegexCodegen{sdata::s_token_lexer, "token_lexer_generated"};
+  os << FOOTER;
+
+  return os ? 0 : 1;
+}